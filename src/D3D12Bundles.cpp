@@ -775,8 +775,8 @@ void D3D12Bundles::BuildRenderIdems()
 
 void D3D12Bundles::DrawSignalSlot(SignalSlot& slot)
 {
-	//items per second
-	const unsigned int itemsPerSecond = 1000;
+	//items per second, second has same width whatever the rate of slot
+	const unsigned int itemsPerSecond = slot.GetSamplingRate();
 	const float secondWidth = 20.f;
 	const float itemDistance = (float)secondWidth / itemsPerSecond;
 	const unsigned int numInstances = slot.size();
@@ -0,0 +1,219 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "FFTPlan.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+enum class BatchLayout
+{
+	Planar,		//channel after channel, sample n of channel c at [c * N + n]
+	Interleaved	//sample after sample, sample n of channel c at [n * K + c]
+};
+
+//same size FFT over many channels with one shared plan
+//small power of two sizes transform groups of channels together, every sample becomes a vector of
+//channel lanes so butterflies run vectorized across channels, other sizes run plan per channel
+//groups and channels are spread across thread pool
+template<typename Real>
+class BatchFftT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	BatchFftT(unsigned int size, unsigned int numChannels, FftDirection direction) :
+		_size(size),
+		_numChannels(numChannels),
+		_direction(direction),
+		_plan(GetFftPlan<Real>(size, direction))
+	{
+		if (UseLanes())
+		{
+			BuildLaneTables();
+		}
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	//input holds GetNumChannels() signals in given layout, output receives spectra one after another (planar)
+	void Execute(const ComplexT* input, BatchLayout layout, ComplexT* output) const
+	{
+		Run(Source{ input, nullptr, layout }, output);
+	}
+
+	//channels[c] points to GetSize() samples of channel c
+	void Execute(const ComplexT* const* channels, ComplexT* output) const
+	{
+		Run(Source{ nullptr, channels, BatchLayout::Planar }, output);
+	}
+
+private:
+	static const unsigned int lanes = 16;
+	static const unsigned int maxLaneSize = 4096;
+
+	struct Source
+	{
+		const ComplexT* data;
+		const ComplexT* const* channels;
+		BatchLayout layout;
+	};
+
+	ComplexT GetSample(const Source& source, unsigned int channel, unsigned int index) const
+	{
+		if (source.channels != nullptr)
+		{
+			return source.channels[channel][index];
+		}
+		if (source.layout == BatchLayout::Interleaved)
+		{
+			return source.data[static_cast<size_t>(index) * _numChannels + channel];
+		}
+		return source.data[static_cast<size_t>(channel) * _size + index];
+	}
+
+	bool UseLanes() const
+	{
+		return _size >= 2 && _size <= maxLaneSize && FftPlanT<Real>::IsPowerOfTwo(_size) && _numChannels > 1;
+	}
+
+	void BuildLaneTables()
+	{
+		double sign = _direction == FftDirection::Forward ? -1.0 : 1.0;
+
+		unsigned int numBits = 0;
+		while ((1u << numBits) < _size)
+		{
+			++numBits;
+		}
+
+		_permutation.resize(_size);
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			unsigned int reversed = 0;
+			for (unsigned int bit = 0; bit < numBits; ++bit)
+			{
+				reversed |= ((index >> bit) & 1u) << (numBits - 1 - bit);
+			}
+			_permutation[index] = reversed;
+		}
+
+		//twiddle of stage item k is repeated for every lane, so lane data looks like one N * lanes transform
+		//whose stages start at halfStage = lanes
+		AlignedVector<Real> re, im, cubeRe, cubeIm;
+		BuildSplitTwiddles(_size, sign, re, im, cubeRe, cubeIm);
+
+		size_t laneSize = static_cast<size_t>(_size) * lanes;
+		_laneTwiddleRe.resize(laneSize);
+		_laneTwiddleIm.resize(laneSize);
+		_laneCubeRe.resize(laneSize);
+		_laneCubeIm.resize(laneSize);
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			for (unsigned int lane = 0; lane < lanes; ++lane)
+			{
+				_laneTwiddleRe[index * lanes + lane] = re[index];
+				_laneTwiddleIm[index * lanes + lane] = im[index];
+				_laneCubeRe[index * lanes + lane] = cubeRe[index];
+				_laneCubeIm[index * lanes + lane] = cubeIm[index];
+			}
+		}
+	}
+
+	void Run(const Source& source, ComplexT* output) const
+	{
+		if (UseLanes())
+		{
+			unsigned int numGroups = (_numChannels + lanes - 1) / lanes;
+			GetThreadPool().ParallelFor(numGroups, [&](unsigned int groupBegin, unsigned int groupEnd)
+			{
+				for (unsigned int group = groupBegin; group < groupEnd; ++group)
+				{
+					RunGroup(source, group * lanes, output);
+				}
+			});
+			return;
+		}
+
+		GetThreadPool().ParallelFor(_numChannels, [&](unsigned int channelBegin, unsigned int channelEnd)
+		{
+			for (unsigned int channel = channelBegin; channel < channelEnd; ++channel)
+			{
+				ComplexT* spectrum = output + static_cast<size_t>(channel) * _size;
+
+				if (source.channels == nullptr && source.layout == BatchLayout::Planar)
+				{
+					_plan->Execute(source.data + static_cast<size_t>(channel) * _size, spectrum);
+					continue;
+				}
+
+				for (unsigned int index = 0; index < _size; ++index)
+				{
+					spectrum[index] = GetSample(source, channel, index);
+				}
+				_plan->Execute(spectrum);
+			}
+		});
+	}
+
+	//transforms up to lanes channels starting at firstChannel
+	void RunGroup(const Source& source, unsigned int firstChannel, ComplexT* output) const
+	{
+		thread_local AlignedVector<Real> re;
+		thread_local AlignedVector<Real> im;
+		size_t laneSize = static_cast<size_t>(_size) * lanes;
+		if (re.size() < laneSize)
+		{
+			re.resize(laneSize);
+			im.resize(laneSize);
+		}
+
+		unsigned int groupChannels = _numChannels - firstChannel < lanes ? _numChannels - firstChannel : lanes;
+
+		//gather in bit reversed order, unused lanes are zero
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			size_t target = static_cast<size_t>(_permutation[index]) * lanes;
+			for (unsigned int lane = 0; lane < lanes; ++lane)
+			{
+				ComplexT sample = lane < groupChannels ? GetSample(source, firstChannel + lane, index) : ComplexT{ Real(0), Real(0) };
+				re[target + lane] = sample.first;
+				im[target + lane] = sample.second;
+			}
+		}
+
+		SplitTwiddles<Real> twiddles{ _laneTwiddleRe.data(), _laneTwiddleIm.data(), _laneCubeRe.data(), _laneCubeIm.data(),
+			_direction == FftDirection::Forward ? Real(-1) : Real(1) };
+		SplitButterflies(re.data(), im.data(), static_cast<unsigned int>(laneSize), twiddles, lanes);
+
+		for (unsigned int lane = 0; lane < groupChannels; ++lane)
+		{
+			ComplexT* spectrum = output + static_cast<size_t>(firstChannel + lane) * _size;
+			for (unsigned int index = 0; index < _size; ++index)
+			{
+				spectrum[index] = { re[static_cast<size_t>(index) * lanes + lane], im[static_cast<size_t>(index) * lanes + lane] };
+			}
+		}
+	}
+
+	unsigned int _size{ 0 };
+	unsigned int _numChannels{ 0 };
+	FftDirection _direction{ FftDirection::Forward };
+	FftPlanPtr<Real> _plan;
+	std::vector<unsigned int> _permutation;
+	AlignedVector<Real> _laneTwiddleRe;
+	AlignedVector<Real> _laneTwiddleIm;
+	AlignedVector<Real> _laneCubeRe;
+	AlignedVector<Real> _laneCubeIm;
+};
+
+using BatchFft = BatchFftT<float>;
@@ -0,0 +1,167 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+#include <math.h>
+#include "FFTPlan.h"
+#include "SimdKernels.h"
+
+//plain radix-2 FFT that FastFT used before radix-4 passes, kept as baseline for FftBenchmark
+class Radix2ReferenceFft
+{
+public:
+	Radix2ReferenceFft(unsigned int size) :
+		_size(size)
+	{
+		const double twoPi = 6.283185307179586476925;
+
+		unsigned int numBits = 0;
+		while ((1u << numBits) < size)
+		{
+			++numBits;
+		}
+
+		_permutation.resize(size);
+		for (unsigned int index = 0; index < size; ++index)
+		{
+			unsigned int reversed = 0;
+			for (unsigned int bit = 0; bit < numBits; ++bit)
+			{
+				reversed |= ((index >> bit) & 1u) << (numBits - 1 - bit);
+			}
+			_permutation[index] = reversed;
+		}
+
+		_twiddles.resize(size > 1 ? size - 1 : 0);
+		for (unsigned int halfStage = 1; halfStage < size; halfStage <<= 1)
+		{
+			for (unsigned int k = 0; k < halfStage; ++k)
+			{
+				double angle = -twoPi * k / (2.0 * halfStage);
+				_twiddles[halfStage - 1 + k] = { static_cast<float>(cos(angle)), static_cast<float>(sin(angle)) };
+			}
+		}
+	}
+
+	void Execute(std::vector<std::pair<float, float>>& data) const
+	{
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			unsigned int reversed = _permutation[index];
+			if (index < reversed)
+			{
+				std::swap(data[index], data[reversed]);
+			}
+		}
+
+		for (unsigned int halfStage = 1; halfStage < _size; halfStage <<= 1)
+		{
+			const std::pair<float, float>* stageTwiddles = &_twiddles[halfStage - 1];
+
+			for (unsigned int blockStart = 0; blockStart < _size; blockStart += 2 * halfStage)
+			{
+				std::pair<float, float>* even = &data[blockStart];
+				std::pair<float, float>* odd = even + halfStage;
+
+				for (unsigned int k = 0; k < halfStage; ++k)
+				{
+					const std::pair<float, float>& twiddle = stageTwiddles[k];
+
+					float oddReal = twiddle.first * odd[k].first - twiddle.second * odd[k].second;
+					float oddImg = twiddle.first * odd[k].second + twiddle.second * odd[k].first;
+
+					odd[k] = { even[k].first - oddReal, even[k].second - oddImg };
+					even[k] = { even[k].first + oddReal, even[k].second + oddImg };
+				}
+			}
+		}
+	}
+
+private:
+	unsigned int _size{ 0 };
+	std::vector<unsigned int> _permutation;
+	std::vector<std::pair<float, float>> _twiddles;
+};
+
+//real flops of radix-2 transform, every butterfly is one complex multiply (6) and two complex adds (4)
+double Radix2Flops(unsigned int size)
+{
+	double stages = log2(static_cast<double>(size));
+	return 5.0 * size * stages;
+}
+
+//real flops of radix-4 passes, every 4 item butterfly is 3 complex multiplies (18) and 8 complex adds (16),
+//odd number of stages adds one radix-2 stage
+double Radix4Flops(unsigned int size)
+{
+	unsigned int stages = static_cast<unsigned int>(log2(static_cast<double>(size)) + 0.5);
+	double flops = 34.0 * (size / 4) * (stages / 2);
+	if (stages % 2 != 0)
+	{
+		flops += 10.0 * (size / 2);
+	}
+	return flops;
+}
+
+//average microseconds of one call, repeats until enough time has passed for stable numbers
+template<typename Transform>
+double TimeTransform(std::vector<std::pair<float, float>>& data, Transform&& transform)
+{
+	const double minTotalMicroseconds = 200000.0;
+
+	transform(data);
+
+	unsigned int repeats = 0;
+	double elapsed = 0.0;
+	auto start = std::chrono::high_resolution_clock::now();
+	while (elapsed < minTotalMicroseconds)
+	{
+		transform(data);
+		++repeats;
+		elapsed = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	return elapsed / repeats;
+}
+
+//compares plain radix-2 baseline with radix-4 plans (scalar and vectorized) for sizes 256 to 1M,
+//prints flop counts and time of one forward transform
+void FftBenchmark()
+{
+	SimdLevel previousLimit = static_cast<SimdLevel>(SimdLevelLimit().load());
+
+	std::cout << "\n\nFFT benchmark, times in microseconds\n";
+	std::cout << std::setw(10) << "N" << std::setw(14) << "radix2 flops" << std::setw(14) << "radix4 flops"
+		<< std::setw(12) << "radix2" << std::setw(12) << "radix4" << std::setw(12) << "radix4 simd" << std::setw(10) << "speedup" << "\n";
+
+	for (unsigned int size = 256; size <= (1u << 20); size <<= 1)
+	{
+		std::vector<std::pair<float, float>> data(size);
+		for (unsigned int index = 0; index < size; ++index)
+		{
+			data[index] = { static_cast<float>(sin(0.1 * index)), 0.0f };
+		}
+
+		Radix2ReferenceFft reference(size);
+		double referenceTime = TimeTransform(data, [&](std::vector<std::pair<float, float>>& values) { reference.Execute(values); });
+
+		SetSimdLevelLimit(SimdLevel::Scalar);
+		FftPlanT<float> scalarPlan(size, FftDirection::Forward);
+		double scalarTime = TimeTransform(data, [&](std::vector<std::pair<float, float>>& values) { scalarPlan.Execute(values); });
+
+		SetSimdLevelLimit(previousLimit);
+		FftPlanT<float> simdPlan(size, FftDirection::Forward);
+		double simdTime = TimeTransform(data, [&](std::vector<std::pair<float, float>>& values) { simdPlan.Execute(values); });
+
+		std::cout << std::fixed << std::setprecision(0)
+			<< std::setw(10) << size << std::setw(14) << Radix2Flops(size) << std::setw(14) << Radix4Flops(size)
+			<< std::setprecision(1) << std::setw(12) << referenceTime << std::setw(12) << scalarTime << std::setw(12) << simdTime
+			<< std::setprecision(2) << std::setw(10) << referenceTime / simdTime << "\n";
+	}
+
+	SetSimdLevelLimit(previousLimit);
+	std::cout.unsetf(std::ios_base::floatfield);
+	std::cout << "\n";
+}
\ No newline at end of file
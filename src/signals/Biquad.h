@@ -0,0 +1,414 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <math.h>
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+//second order section y = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2) x
+struct BiquadSection
+{
+	double b0;
+	double b1;
+	double b2;
+	double a1;
+	double a2;
+};
+
+//rbj cookbook sections, frequency is fraction of sampling rate (0..0.5)
+inline BiquadSection MakeBiquad(double b0, double b1, double b2, double a0, double a1, double a2)
+{
+	return { b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0 };
+}
+
+inline BiquadSection DesignBiquadLowPass(double frequency, double q = 0.70710678118654752)
+{
+	double omega = 6.283185307179586476925 * frequency;
+	double cosOmega = cos(omega);
+	double alpha = sin(omega) / (2.0 * q);
+	return MakeBiquad((1.0 - cosOmega) / 2.0, 1.0 - cosOmega, (1.0 - cosOmega) / 2.0, 1.0 + alpha, -2.0 * cosOmega, 1.0 - alpha);
+}
+
+inline BiquadSection DesignBiquadHighPass(double frequency, double q = 0.70710678118654752)
+{
+	double omega = 6.283185307179586476925 * frequency;
+	double cosOmega = cos(omega);
+	double alpha = sin(omega) / (2.0 * q);
+	return MakeBiquad((1.0 + cosOmega) / 2.0, -(1.0 + cosOmega), (1.0 + cosOmega) / 2.0, 1.0 + alpha, -2.0 * cosOmega, 1.0 - alpha);
+}
+
+//0 db gain at frequency, bandwidth is frequency / q
+inline BiquadSection DesignBiquadBandPass(double frequency, double q)
+{
+	double omega = 6.283185307179586476925 * frequency;
+	double cosOmega = cos(omega);
+	double alpha = sin(omega) / (2.0 * q);
+	return MakeBiquad(alpha, 0.0, -alpha, 1.0 + alpha, -2.0 * cosOmega, 1.0 - alpha);
+}
+
+//zero at frequency, higher q gives narrower notch
+inline BiquadSection DesignBiquadNotch(double frequency, double q = 10.0)
+{
+	double omega = 6.283185307179586476925 * frequency;
+	double cosOmega = cos(omega);
+	double alpha = sin(omega) / (2.0 * q);
+	return MakeBiquad(1.0, -2.0 * cosOmega, 1.0, 1.0 + alpha, -2.0 * cosOmega, 1.0 - alpha);
+}
+
+inline void RunBiquadLanes(float* data, unsigned int count, const float* coefficients, unsigned int numSections, float* state, unsigned int width, BiquadLanesKernel kernel)
+{
+	if (kernel != nullptr)
+	{
+		kernel(data, count, coefficients, numSections, state);
+		return;
+	}
+	BiquadLanesScalar(data, count, coefficients, numSections, state, width);
+}
+
+inline void RunBiquadLanes(double* data, unsigned int count, const double* coefficients, unsigned int numSections, double* state, unsigned int width, BiquadLanesKernel)
+{
+	BiquadLanesScalar(data, count, coefficients, numSections, state, width);
+}
+
+//cascade of second order sections over channels with state kept between blocks
+//recursion of IIR cannot be vectorized along samples, so channels are packed into groups of one SIMD register
+//(4/8/16 float channels) and whole group is filtered by one instruction stream, groups run on thread pool
+//ProcessParallel handles few long channels: chunks are filtered from zero state in parallel, true start states
+//are carried across chunks with precomputed state transition matrix, then zero input response of start state is added
+template<typename Real>
+class BiquadCascadeT
+{
+public:
+	BiquadCascadeT(const std::vector<BiquadSection>& sections, unsigned int numChannels = 1) :
+		_sections(sections),
+		_numSections(static_cast<unsigned int>(sections.size())),
+		_numChannels(numChannels)
+	{
+		SimdLevel level = GetSimdLevel();
+		_kernel = std::is_same<Real, float>::value ? GetBiquadLanesKernel(level) : nullptr;
+		_width = _kernel != nullptr ? GetSimdWidth(level) : 1;
+		_numGroups = (_numChannels + _width - 1) / _width;
+
+		_coefficients.resize(5 * _numSections);
+		for (unsigned int section = 0; section < _numSections; ++section)
+		{
+			const BiquadSection& value = _sections[section];
+			Real* c = _coefficients.data() + 5 * section;
+			c[0] = static_cast<Real>(value.b0);
+			c[1] = static_cast<Real>(value.b1);
+			c[2] = static_cast<Real>(value.b2);
+			c[3] = static_cast<Real>(value.a1);
+			c[4] = static_cast<Real>(value.a2);
+		}
+
+		_state.resize(static_cast<size_t>(_numGroups) * GetGroupStateSize());
+		Reset();
+	}
+
+	unsigned int GetNumSections() const
+	{
+		return _numSections;
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	//channels filtered together by one instruction
+	unsigned int GetGroupWidth() const
+	{
+		return _width;
+	}
+
+	//count samples of every channel, channel after channel
+	void Process(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		Run(input, output, 1, count);
+	}
+
+	//single channel
+	void Process(const Real* input, unsigned int count, Real* output)
+	{
+		Run(&input, &output, 1, count);
+	}
+
+	//sample after sample, sample n of channel c at [n * GetNumChannels() + c]
+	void ProcessInterleaved(const Real* input, unsigned int count, Real* output)
+	{
+		std::vector<const Real*> inputs(_numChannels);
+		std::vector<Real*> outputs(_numChannels);
+		for (unsigned int channel = 0; channel < _numChannels; ++channel)
+		{
+			inputs[channel] = input + channel;
+			outputs[channel] = output + channel;
+		}
+		Run(inputs.data(), outputs.data(), _numChannels, count);
+	}
+
+	//same result as Process, for long blocks of few channels, every channel is split across thread pool
+	void ProcessParallel(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		unsigned int numChunks = GetThreadPool().GetNumThreads();
+		if (numChunks <= 1 || count < numChunks * minScanChunk || _numSections == 0)
+		{
+			Process(input, count, output);
+			return;
+		}
+
+		for (unsigned int channel = 0; channel < _numChannels; ++channel)
+		{
+			RunScan(channel, input[channel], count, output[channel], numChunks);
+		}
+	}
+
+	void ProcessParallel(const Real* input, unsigned int count, Real* output)
+	{
+		ProcessParallel(&input, count, &output);
+	}
+
+	void Reset()
+	{
+		std::fill(_state.begin(), _state.end(), Real(0));
+	}
+
+private:
+	static const unsigned int blockSize = 256;
+	static const unsigned int minScanChunk = 16384;
+
+	size_t GetGroupStateSize() const
+	{
+		return static_cast<size_t>(2) * _width * _numSections;
+	}
+
+	//state of section in lane layout of group
+	Real& GetState(unsigned int channel, unsigned int section, unsigned int item)
+	{
+		unsigned int group = channel / _width;
+		unsigned int lane = channel % _width;
+		return _state[group * GetGroupStateSize() + 2 * _width * section + item * _width + lane];
+	}
+
+	//sample n of channel c is at input[c][n * stride]
+	void Run(const Real* const* input, Real* const* output, unsigned int stride, unsigned int count)
+	{
+		GetThreadPool().ParallelFor(_numGroups, [&](unsigned int groupBegin, unsigned int groupEnd)
+		{
+			thread_local AlignedVector<Real> lanes;
+			lanes.resize(static_cast<size_t>(blockSize) * _width);
+
+			for (unsigned int group = groupBegin; group < groupEnd; ++group)
+			{
+				unsigned int firstChannel = group * _width;
+				unsigned int numLanes = (std::min)(_width, _numChannels - firstChannel);
+				Real* state = _state.data() + group * GetGroupStateSize();
+
+				for (unsigned int blockStart = 0; blockStart < count; blockStart += blockSize)
+				{
+					unsigned int numSamples = count - blockStart < blockSize ? count - blockStart : blockSize;
+
+					//unused lanes of last group filter zeros
+					for (unsigned int index = 0; index < numSamples; ++index)
+					{
+						size_t position = static_cast<size_t>(blockStart + index) * stride;
+						Real* item = lanes.data() + index * _width;
+						for (unsigned int lane = 0; lane < _width; ++lane)
+						{
+							item[lane] = lane < numLanes ? input[firstChannel + lane][position] : Real(0);
+						}
+					}
+
+					RunBiquadLanes(lanes.data(), numSamples, _coefficients.data(), _numSections, state, _width, _kernel);
+
+					for (unsigned int index = 0; index < numSamples; ++index)
+					{
+						size_t position = static_cast<size_t>(blockStart + index) * stride;
+						const Real* item = lanes.data() + index * _width;
+						for (unsigned int lane = 0; lane < numLanes; ++lane)
+						{
+							output[firstChannel + lane][position] = item[lane];
+						}
+					}
+				}
+			}
+		});
+	}
+
+	//one step of cascade with zero input, state is s1, s2 per section, returns output of last section
+	double StepZeroInput(std::vector<double>& state) const
+	{
+		double x = 0.0;
+		for (unsigned int section = 0; section < _numSections; ++section)
+		{
+			const BiquadSection& c = _sections[section];
+			double y = c.b0 * x + state[2 * section];
+			state[2 * section] = c.b1 * x - c.a1 * y + state[2 * section + 1];
+			state[2 * section + 1] = c.b2 * x - c.a2 * y;
+			x = y;
+		}
+		return x;
+	}
+
+	//state transition matrix of count zero input steps, row major
+	std::vector<double> GetTransition(unsigned int count) const
+	{
+		unsigned int size = 2 * _numSections;
+
+		std::vector<double> step(size * size);
+		std::vector<double> column(size);
+		for (unsigned int item = 0; item < size; ++item)
+		{
+			std::fill(column.begin(), column.end(), 0.0);
+			column[item] = 1.0;
+			StepZeroInput(column);
+			for (unsigned int row = 0; row < size; ++row)
+			{
+				step[row * size + item] = column[row];
+			}
+		}
+
+		auto Multiply = [size](const std::vector<double>& a, const std::vector<double>& b)
+		{
+			std::vector<double> result(size * size, 0.0);
+			for (unsigned int row = 0; row < size; ++row)
+			{
+				for (unsigned int inner = 0; inner < size; ++inner)
+				{
+					double value = a[row * size + inner];
+					for (unsigned int item = 0; item < size; ++item)
+					{
+						result[row * size + item] += value * b[inner * size + item];
+					}
+				}
+			}
+			return result;
+		};
+
+		//power by squaring
+		std::vector<double> result(size * size, 0.0);
+		for (unsigned int item = 0; item < size; ++item)
+		{
+			result[item * size + item] = 1.0;
+		}
+		for (; count > 0; count >>= 1)
+		{
+			if (count & 1)
+			{
+				result = Multiply(result, step);
+			}
+			step = Multiply(step, step);
+		}
+		return result;
+	}
+
+	void RunScan(unsigned int channel, const Real* input, unsigned int count, Real* output, unsigned int numChunks)
+	{
+		unsigned int size = 2 * _numSections;
+
+		auto ChunkStart = [&](unsigned int chunk)
+		{
+			return static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / numChunks);
+		};
+
+		//zero state response and its end state for every chunk
+		std::vector<std::vector<double>> endStates(numChunks, std::vector<double>(size));
+		GetThreadPool().ParallelFor(numChunks, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+		{
+			std::vector<Real> state(size);
+			for (unsigned int chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+			{
+				unsigned int start = ChunkStart(chunk);
+				unsigned int end = ChunkStart(chunk + 1);
+
+				std::copy(input + start, input + end, output + start);
+				std::fill(state.begin(), state.end(), Real(0));
+				BiquadLanesScalar(output + start, end - start, _coefficients.data(), _numSections, state.data(), 1);
+
+				std::copy(state.begin(), state.end(), endStates[chunk].begin());
+			}
+		}, 1);
+
+		//true start state of every chunk, sequential but only size x size work per chunk
+		std::vector<std::vector<double>> startStates(numChunks, std::vector<double>(size));
+		std::vector<double> state(size);
+		for (unsigned int section = 0; section < _numSections; ++section)
+		{
+			state[2 * section] = GetState(channel, section, 0);
+			state[2 * section + 1] = GetState(channel, section, 1);
+		}
+
+		for (unsigned int chunk = 0; chunk < numChunks; ++chunk)
+		{
+			startStates[chunk] = state;
+
+			std::vector<double> transition = GetTransition(ChunkStart(chunk + 1) - ChunkStart(chunk));
+			for (unsigned int row = 0; row < size; ++row)
+			{
+				double sum = endStates[chunk][row];
+				for (unsigned int item = 0; item < size; ++item)
+				{
+					sum += transition[row * size + item] * startStates[chunk][item];
+				}
+				state[row] = sum;
+			}
+		}
+
+		for (unsigned int section = 0; section < _numSections; ++section)
+		{
+			GetState(channel, section, 0) = static_cast<Real>(state[2 * section]);
+			GetState(channel, section, 1) = static_cast<Real>(state[2 * section + 1]);
+		}
+
+		//add zero input response of start state, stops once state decayed below float precision
+		GetThreadPool().ParallelFor(numChunks, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+		{
+			for (unsigned int chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+			{
+				std::vector<double>& chunkState = startStates[chunk];
+
+				double initial = 0.0;
+				for (double value : chunkState)
+				{
+					initial = (std::max)(initial, fabs(value));
+				}
+				if (initial == 0.0)
+				{
+					continue;
+				}
+
+				unsigned int start = ChunkStart(chunk);
+				unsigned int end = ChunkStart(chunk + 1);
+				for (unsigned int index = start; index < end; ++index)
+				{
+					output[index] += static_cast<Real>(StepZeroInput(chunkState));
+
+					if ((index - start) % 64 == 63)
+					{
+						double largest = 0.0;
+						for (double value : chunkState)
+						{
+							largest = (std::max)(largest, fabs(value));
+						}
+						if (largest < initial * 1e-12)
+						{
+							break;
+						}
+					}
+				}
+			}
+		}, 1);
+	}
+
+	std::vector<BiquadSection> _sections;
+	unsigned int _numSections{ 0 };
+	unsigned int _numChannels{ 0 };
+	unsigned int _width{ 1 };
+	unsigned int _numGroups{ 0 };
+	BiquadLanesKernel _kernel{ nullptr };
+	AlignedVector<Real> _coefficients;
+	AlignedVector<Real> _state;
+};
+
+using BiquadCascade = BiquadCascadeT<float>;
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "FFTPlan.h"
+
+//chirp-Z transform, M bins on line w_k = w0 + k * dw that need not match FFT grid of N samples
+//kn = (k^2 + n^2 - (k-n)^2) / 2 turns sum into convolution with chirp exp(i dw m^2 / 2)
+//which is done with power of two FFT of size L >= N + M - 1, so cost is O(L log L) for any M and range
+//used as zoom FFT: fine resolution over narrow band without zero padding whole signal
+template<typename Real>
+class ChirpZT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//bins are in units of N point DFT bins, bin b is frequency b * samplingRate / N, fractional values allowed
+	ChirpZT(unsigned int size, unsigned int numBins, double startBin, double binStep) :
+		_size(size),
+		_numBins(numBins)
+	{
+		_convolutionSize = 1;
+		while (_convolutionSize + 1 < size + numBins)
+		{
+			_convolutionSize <<= 1;
+		}
+
+		_forwardPlan = GetFftPlan<Real>(_convolutionSize, FftDirection::Forward);
+		_inversePlan = GetFftPlan<Real>(_convolutionSize, FftDirection::Inverse);
+
+		BuildChirps(startBin, binStep);
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	unsigned int GetNumBins() const
+	{
+		return _numBins;
+	}
+
+	//input has GetSize() samples, output receives GetNumBins() bins, no 1/N scaling like forward FFT
+	void Execute(const ComplexT* input, ComplexT* output) const
+	{
+		thread_local std::vector<ComplexT> work;
+		work.resize(_convolutionSize);
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			work[index] = Multiply(input[index], _inputChirp[index]);
+		}
+		std::fill(work.begin() + _size, work.end(), ComplexT{ Real(0), Real(0) });
+
+		_forwardPlan->Execute(work.data());
+		for (unsigned int index = 0; index < _convolutionSize; ++index)
+		{
+			work[index] = Multiply(work[index], _filterSpectrum[index]);
+		}
+		_inversePlan->Execute(work.data());
+
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			output[bin] = Multiply(work[bin], _outputChirp[bin]);
+		}
+	}
+
+private:
+	static ComplexT Multiply(const ComplexT& a, const ComplexT& b)
+	{
+		return { a.first * b.first - a.second * b.second, a.first * b.second + a.second * b.first };
+	}
+
+	static ComplexT Polar(double angle)
+	{
+		//reduce before cast, m^2 terms grow large
+		angle = fmod(angle, 6.283185307179586476925);
+		return { static_cast<Real>(cos(angle)), static_cast<Real>(sin(angle)) };
+	}
+
+	void BuildChirps(double startBin, double binStep)
+	{
+		const double twoPi = 6.283185307179586476925;
+		double startOmega = _size != 0 ? twoPi * startBin / _size : 0.0;
+		double stepOmega = _size != 0 ? twoPi * binStep / _size : 0.0;
+
+		//x[n] * exp(-i w0 n) * exp(-i dw n^2 / 2)
+		_inputChirp.resize(_size);
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			double n = index;
+			_inputChirp[index] = Polar(-startOmega * n - stepOmega * n * n / 2.0);
+		}
+
+		//exp(-i dw k^2 / 2)
+		_outputChirp.resize(_numBins);
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			double k = bin;
+			_outputChirp[bin] = Polar(-stepOmega * k * k / 2.0);
+		}
+
+		//filter exp(i dw m^2 / 2) for m = -(N-1)..(M-1), negative m wrap to end of circular buffer,
+		//1/L of inverse transform is folded in
+		_filterSpectrum.assign(_convolutionSize, ComplexT{ Real(0), Real(0) });
+		for (unsigned int index = 0; index < _numBins; ++index)
+		{
+			double m = index;
+			_filterSpectrum[index] = Polar(stepOmega * m * m / 2.0);
+		}
+		for (unsigned int index = 1; index < _size; ++index)
+		{
+			double m = index;
+			_filterSpectrum[_convolutionSize - index] = Polar(stepOmega * m * m / 2.0);
+		}
+
+		_forwardPlan->Execute(_filterSpectrum.data());
+
+		Real scale = Real(1) / _convolutionSize;
+		for (auto& value : _filterSpectrum)
+		{
+			value.first *= scale;
+			value.second *= scale;
+		}
+	}
+
+	unsigned int _size{ 0 };
+	unsigned int _numBins{ 0 };
+	unsigned int _convolutionSize{ 0 };
+	FftPlanPtr<Real> _forwardPlan;
+	FftPlanPtr<Real> _inversePlan;
+	std::vector<ComplexT> _inputChirp;
+	std::vector<ComplexT> _outputChirp;
+	std::vector<ComplexT> _filterSpectrum;
+};
+
+using ChirpZ = ChirpZT<float>;
\ No newline at end of file
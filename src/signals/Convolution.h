@@ -0,0 +1,262 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "FFTPlan.h"
+#include "ThreadPool.h"
+
+//linear convolution y[n] = sum h[k] * x[n-k] with FFT, overlap-save:
+//every block transforms last M-1 samples of previous block plus H = L-M+1 new ones, multiplies by kernel spectrum
+//and keeps last H outputs which are free of circular wrap, cost is O(log L) per sample instead of O(M)
+//FFT size L is picked from kernel length to minimize work per output sample, plans are shared across blocks
+//whole signals are split into blocks running in parallel, streaming input is processed block after block
+template<typename Real>
+class FftConvolverT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//fftSize 0 picks size from kernel length
+	FftConvolverT(const ComplexT* kernel, unsigned int kernelSize, unsigned int fftSize = 0) :
+		_kernelSize(kernelSize)
+	{
+		_fftSize = fftSize != 0 ? fftSize : ChooseFftSize(kernelSize);
+		if (_fftSize < kernelSize)
+		{
+			_fftSize = ChooseFftSize(kernelSize);
+		}
+		_blockSize = _fftSize - (kernelSize > 0 ? kernelSize - 1 : 0);
+
+		_forwardPlan = GetFftPlan<Real>(_fftSize, FftDirection::Forward);
+		_inversePlan = GetFftPlan<Real>(_fftSize, FftDirection::Inverse);
+
+		BuildKernelSpectrum(kernel);
+		Reset();
+	}
+
+	//convolver whose output is cross correlation with reference, r[l] = sum x[n+l] * conj(reference[n]),
+	//output sample j of full convolution is lag j - (referenceSize - 1)
+	static FftConvolverT Correlator(const ComplexT* reference, unsigned int referenceSize, unsigned int fftSize = 0)
+	{
+		std::vector<ComplexT> kernel(referenceSize);
+		for (unsigned int index = 0; index < referenceSize; ++index)
+		{
+			const ComplexT& value = reference[referenceSize - 1 - index];
+			kernel[index] = { value.first, -value.second };
+		}
+
+		return FftConvolverT(kernel.data(), referenceSize, fftSize);
+	}
+
+	//smallest power of two with fewest operations per output sample, L log L / (L - M + 1)
+	//size is always at least 2 M so block size stays positive, maxFftSize only limits growth past that
+	static unsigned int ChooseFftSize(unsigned int kernelSize)
+	{
+		const unsigned int minFftSize = 64;
+		const unsigned int maxFftSize = 1u << 22;
+
+		unsigned int fftSize = minFftSize;
+		while (fftSize / 2 < kernelSize)
+		{
+			fftSize <<= 1;
+		}
+
+		double bestCost = Cost(fftSize, kernelSize);
+		while (fftSize < maxFftSize && Cost(2 * fftSize, kernelSize) < bestCost)
+		{
+			fftSize <<= 1;
+			bestCost = Cost(fftSize, kernelSize);
+		}
+
+		return fftSize;
+	}
+
+	//for whole signal of signalSize samples, no larger than single block holding entire convolution
+	static unsigned int ChooseFftSize(unsigned int kernelSize, unsigned int signalSize)
+	{
+		unsigned int fftSize = ChooseFftSize(kernelSize);
+
+		unsigned int outputSize = signalSize + kernelSize;
+		while (fftSize > 64 && fftSize / 2 >= outputSize)
+		{
+			fftSize >>= 1;
+		}
+
+		return fftSize;
+	}
+
+	unsigned int GetKernelSize() const
+	{
+		return _kernelSize;
+	}
+
+	unsigned int GetFftSize() const
+	{
+		return _fftSize;
+	}
+
+	//new samples consumed per block
+	unsigned int GetBlockSize() const
+	{
+		return _blockSize;
+	}
+
+	//full convolution of whole signal, output has inputSize + GetKernelSize() - 1 samples
+	//does not touch streaming state
+	void Convolve(const ComplexT* input, unsigned int inputSize, ComplexT* output) const
+	{
+		if (inputSize == 0 || _kernelSize == 0)
+		{
+			return;
+		}
+
+		unsigned int outputSize = inputSize + _kernelSize - 1;
+		unsigned int numBlocks = (outputSize + _blockSize - 1) / _blockSize;
+		unsigned int history = _kernelSize - 1;
+
+		GetThreadPool().ParallelFor(numBlocks, [&](unsigned int blockBegin, unsigned int blockEnd)
+		{
+			std::vector<ComplexT>& work = GetThreadWork();
+
+			for (unsigned int block = blockBegin; block < blockEnd; ++block)
+			{
+				//block input starts history samples before first output, zeros outside signal
+				long long start = static_cast<long long>(block) * _blockSize - history;
+				for (unsigned int index = 0; index < _fftSize; ++index)
+				{
+					long long position = start + index;
+					work[index] = position >= 0 && position < inputSize ? input[position] : ComplexT{ Real(0), Real(0) };
+				}
+
+				Filter(work.data());
+
+				unsigned int first = block * _blockSize;
+				unsigned int count = (std::min)(_blockSize, outputSize - first);
+				std::copy(work.begin() + history, work.begin() + history + count, output + first);
+			}
+		});
+	}
+
+	//streaming convolution, appends every finished output sample to output
+	//outputs come in whole blocks so they lag input by up to GetBlockSize() - 1 samples
+	void Process(const ComplexT* input, unsigned int count, std::vector<ComplexT>& output)
+	{
+		if (_kernelSize == 0)
+		{
+			return;
+		}
+
+		for (unsigned int index = 0; index < count; ++index)
+		{
+			_buffer[_kernelSize - 1 + _numPending] = input[index];
+			if (++_numPending == _blockSize)
+			{
+				RunStreamBlock(output);
+			}
+		}
+	}
+
+	//pushes zeros until all pending samples and kernel tail (GetKernelSize() - 1 samples) are out, then resets
+	void Flush(std::vector<ComplexT>& output)
+	{
+		if (_kernelSize == 0)
+		{
+			return;
+		}
+
+		unsigned int remaining = _numPending + _kernelSize - 1;
+		while (remaining > 0)
+		{
+			unsigned int produced = (std::min)(remaining, _blockSize);
+
+			std::fill(_buffer.begin() + _kernelSize - 1 + _numPending, _buffer.end(), ComplexT{ Real(0), Real(0) });
+			_numPending = _blockSize;
+
+			size_t outputStart = output.size();
+			RunStreamBlock(output);
+			output.resize(outputStart + produced);
+
+			remaining -= produced;
+		}
+		Reset();
+	}
+
+	void Reset()
+	{
+		_buffer.assign(_fftSize, ComplexT{ Real(0), Real(0) });
+		_numPending = 0;
+	}
+
+private:
+	static double Cost(unsigned int fftSize, unsigned int kernelSize)
+	{
+		return fftSize * log2(static_cast<double>(fftSize)) / (fftSize - kernelSize + 1);
+	}
+
+	std::vector<ComplexT>& GetThreadWork() const
+	{
+		thread_local std::vector<ComplexT> work;
+		if (work.size() < _fftSize)
+		{
+			work.resize(_fftSize);
+		}
+		return work;
+	}
+
+	void BuildKernelSpectrum(const ComplexT* kernel)
+	{
+		//1/L of inverse transform is folded in
+		Real scale = Real(1) / _fftSize;
+
+		_kernelSpectrum.assign(_fftSize, ComplexT{ Real(0), Real(0) });
+		for (unsigned int index = 0; index < _kernelSize; ++index)
+		{
+			_kernelSpectrum[index] = { kernel[index].first * scale, kernel[index].second * scale };
+		}
+
+		_forwardPlan->Execute(_kernelSpectrum.data());
+	}
+
+	//circular convolution of work with kernel
+	void Filter(ComplexT* work) const
+	{
+		_forwardPlan->Execute(work);
+
+		for (unsigned int index = 0; index < _fftSize; ++index)
+		{
+			const ComplexT& a = work[index];
+			const ComplexT& b = _kernelSpectrum[index];
+			work[index] = { a.first * b.first - a.second * b.second, a.first * b.second + a.second * b.first };
+		}
+
+		_inversePlan->Execute(work);
+	}
+
+	//_buffer holds M-1 history samples followed by GetBlockSize() new ones
+	void RunStreamBlock(std::vector<ComplexT>& output)
+	{
+		std::vector<ComplexT>& work = GetThreadWork();
+		std::copy(_buffer.begin(), _buffer.end(), work.begin());
+
+		Filter(work.data());
+
+		unsigned int history = _kernelSize - 1;
+		output.insert(output.end(), work.begin() + history, work.begin() + _fftSize);
+
+		//last M-1 input samples become history of next block
+		std::copy(_buffer.end() - history, _buffer.end(), _buffer.begin());
+		_numPending = 0;
+	}
+
+	unsigned int _kernelSize{ 0 };
+	unsigned int _fftSize{ 0 };
+	unsigned int _blockSize{ 0 };
+	FftPlanPtr<Real> _forwardPlan;
+	FftPlanPtr<Real> _inversePlan;
+	std::vector<ComplexT> _kernelSpectrum;
+	std::vector<ComplexT> _buffer;
+	unsigned int _numPending{ 0 };
+};
+
+using FftConvolver = FftConvolverT<float>;
\ No newline at end of file
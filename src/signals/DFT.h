@@ -1,6 +1,24 @@
 #pragma once
 #include "Signal.h"
 #include "Util.h"
+#include "FFTPlan.h"
+#include "RealFFT.h"
+#include "LargeFFT.h"
+#include "BatchFFT.h"
+#include "Goertzel.h"
+#include "ChirpZ.h"
+#include "PrunedDFT.h"
+#include "SparseSynthesis.h"
+#include "Convolution.h"
+#include "PartitionedConvolution.h"
+#include "STFT.h"
+#include "Welch.h"
+#include "Spectrum.h"
+#include "WindowFunctions.h"
+#include "FIR.h"
+#include "Biquad.h"
+#include "Resampler.h"
+#include "Farrow.h"
 
 std::pair<float, float>RawSignalDot(const RawSignalPtr& signal1, RawSignalPtr& signal2)
 {
@@ -63,7 +81,7 @@ RawSignalPtr AddSignals(const RawSignalPtr& signal1, RawSignalPtr& signal2)
 
 	}
 
-	RawSignalPtr result(new RawSignal(signal1->Size()));
+	RawSignalPtr result(new RawSignal(signal1->Size(), signal1->GetSamplingRate()));
 
 	for (unsigned int index = 0; index < signal1->Size(); ++index)
 	{
@@ -91,13 +109,13 @@ RawSignalPtr DiscreteFT(const RawSignalPtr& signal)
 	unsigned int signalSize = signal->Size();
 
 	//create raw Signal
-	RawSignalPtr result(new RawSignal(signalSize));
+	RawSignalPtr result(new RawSignal(signalSize, signal->GetSamplingRate()));
 
 	for (unsigned int index = 0; index < signalSize; ++index)
 	{
 		//create complex sine wave
 		float frequency = (float)(index);
-		auto& csw = ComplexSineSignal(-1.f, frequency, 0.f, signal->GetLenght()).ToRawSignal();
+		auto& csw = ComplexSineSignal(-1.f, frequency, 0.f, signal->GetLenght()).ToRawSignal(signalSize);
 
 		result->_timeVec[index] = signal->_timeVec[index];
 		//compute dot product
@@ -108,96 +126,799 @@ RawSignalPtr DiscreteFT(const RawSignalPtr& signal)
 }
 
 
-std::vector<std::pair<float, float>> FastFTImpl(const std::vector<std::pair<float, float>>& signal)
+//in place FFT, twiddles and permutation come from cached plan so repeated transforms of same size skip trigonometry
+//sizes above LargeFftThreshold go through multithreaded four step FFT
+void FastFTImpl(std::vector<std::pair<float, float>>& signal, FftDirection direction = FftDirection::Forward)
 {
 	unsigned int numSamples = (unsigned int)signal.size();
 
-	if (numSamples == 1)
+	if (numSamples < 2)
 	{
-		return signal;
+		return;
 	}
 
-	//half of samples Numer
-	unsigned int halfSamples = static_cast<unsigned int>(signal.size()) / 2;
+	if (UseLargeFft(numSamples))
+	{
+		GetFourStepFft(numSamples, direction)->Execute(signal);
+		return;
+	}
+
+	GetFftPlan(numSamples, direction)->Execute(signal);
+}
+
+RawSignalPtr FastFT(const RawSignalPtr& signal)
+{
+	MeasureExecution<>  execution("FastFT");
+
+	unsigned int signalSize = signal->Size();
+
+	RawSignalPtr result(new RawSignal(signalSize, signal->GetSamplingRate()));
+
+	result->_timeVec = signal->_timeVec;
+	result->_dataVec = signal->_dataVec;
+	FastFTImpl(result->_dataVec);
+
+	for (unsigned int i = 0; i < signalSize; ++i)
+	{
+		result->_dataVec[i].first /= (float)signalSize;
+		result->_dataVec[i].second /= (float)signalSize;
+	}
+
+	return move(result);
+}
+
+//FastFT of windowed signal, window is applied by plan while it gathers input so it needs no extra pass
+//coefficients are scaled by 1/sum(window) instead of 1/N so tone amplitudes read the same as with FastFT
+RawSignalPtr FastFT(const RawSignalPtr& signal, WindowType window, double windowParameter = -1.0)
+{
+	MeasureExecution<>  execution("FastFT windowed");
+
+	unsigned int signalSize = signal->Size();
 
-	//declare event and odd halves
-	std::vector < std::pair<float, float> > Even(halfSamples, { 0.f, 0.f });
-	std::vector < std::pair<float, float> > Odd(halfSamples, { 0.f, 0.f });
+	RawSignalPtr result(new RawSignal(signalSize, signal->GetSamplingRate()));
+	result->_timeVec = signal->_timeVec;
+
+	WindowPtr<float> table = GetWindow<float>(window, signalSize, windowParameter);
 
-	//split to even and odd
-	for (unsigned int index = 0; index < halfSamples; ++index)
+	if (signalSize < 2 || UseLargeFft(signalSize))
+	{
+		WindowMultiply(signal->_dataVec.data(), table->data(), result->_dataVec.data(), signalSize);
+		FastFTImpl(result->_dataVec);
+	}
+	else
 	{
-		Even[index] = signal[2 * index];
-		Odd[index] = signal[2 * index + 1];
+		GetFftPlan(signalSize, FftDirection::Forward)->ExecuteWindowed(signal->_dataVec.data(), table->data(), result->_dataVec.data());
 	}
 
-	std::vector<std::pair<float, float>> fEven = FastFTImpl(Even);
-	std::vector<std::pair<float, float>> fOdd = FastFTImpl(Odd);
+	double windowSum = GetWindowSum(table->data(), signalSize);
+	float scale = windowSum != 0.0 ? static_cast<float>(1.0 / windowSum) : 1.f;
+	for (unsigned int i = 0; i < signalSize; ++i)
+	{
+		result->_dataVec[i].first *= scale;
+		result->_dataVec[i].second *= scale;
+	}
 
-	std::vector<std::pair<float, float>> frequbins(numSamples, { 0.f, 0.f });
+	return move(result);
+}
 
-	for (int k = 0; k != halfSamples; ++k)
+//true when every signal holds as many items as first one, batches share one transform size
+bool HaveSameSize(const std::vector<RawSignalPtr>& signals)
+{
+	for (const auto& signal : signals)
 	{
-		Complex complexExponential = ComplexMultiply(
-			CompolexPolar(1.f, -2.f * PI * k / numSamples), fOdd[k]);
+		if (signal->Size() != signals.front()->Size())
+		{
+			return false;
+		}
+	}
+	return true;
+}
 
-		frequbins[k] = ComplexSum(fEven[k], complexExponential);
-		frequbins[k + halfSamples] = ComplexNegation(fEven[k], complexExponential);
+//FastFT over many signals of same size with one shared plan
+//spectra receives signals.size() spectra one after another, scaled by 1/N same as FastFT
+//signals of different sizes are rejected, spectra is then left empty and false is returned
+bool FastFTBatch(const std::vector<RawSignalPtr>& signals, std::vector<Complex>& spectra)
+{
+	MeasureExecution<>  execution("FastFTBatch");
 
+	if (signals.empty() || !HaveSameSize(signals))
+	{
+		spectra.clear();
+		return signals.empty();
+	}
+
+	unsigned int signalSize = signals.front()->Size();
+	unsigned int numChannels = static_cast<unsigned int>(signals.size());
+
+	std::vector<const Complex*> channels(numChannels);
+	for (unsigned int channel = 0; channel < numChannels; ++channel)
+	{
+		channels[channel] = signals[channel]->_dataVec.data();
 	}
 
-	return frequbins;
+	spectra.resize(static_cast<size_t>(signalSize) * numChannels);
+
+	BatchFft batch(signalSize, numChannels, FftDirection::Forward);
+	batch.Execute(channels.data(), spectra.data());
+
+	for (auto& bin : spectra)
+	{
+		bin.first /= (float)signalSize;
+		bin.second /= (float)signalSize;
+	}
+
+	return true;
 }
 
-RawSignalPtr FastFT(const RawSignalPtr& signal)
+//DFT coefficients only at given frequencies (Hz, need not fall on bin), scaled by 1/N same as FastFT
+//O(N) per frequency so few tone checks do not pay for full spectrum
+std::vector<Complex> GoertzelFT(const RawSignalPtr& signal, const std::vector<float>& frequencies)
 {
-	MeasureExecution<>  execution("FastFT");
+	MeasureExecution<std::chrono::microseconds>  execution("GoertzelFT");
+
+	unsigned int signalSize = signal->Size();
+
+	std::vector<double> bins(frequencies.size());
+	for (size_t index = 0; index < frequencies.size(); ++index)
+	{
+		bins[index] = GetBinForFrequency(frequencies[index], signalSize, signal->GetSamplingRate());
+	}
+
+	std::vector<Complex> result(frequencies.size());
+	GoertzelBank bank(signalSize, bins);
+	bank.Execute(signal->_dataVec.data(), result.data());
+
+	for (auto& bin : result)
+	{
+		bin.first /= (float)signalSize;
+		bin.second /= (float)signalSize;
+	}
+
+	return result;
+}
+
+//GoertzelFT over many signals of same size, coefficients of signal c start at coefficients[c * frequencies.size()]
+//signals of different sizes are rejected, coefficients is then left empty and false is returned
+bool GoertzelFTBatch(const std::vector<RawSignalPtr>& signals, const std::vector<float>& frequencies, std::vector<Complex>& coefficients)
+{
+	MeasureExecution<std::chrono::microseconds>  execution("GoertzelFTBatch");
+
+	if (signals.empty() || !HaveSameSize(signals))
+	{
+		coefficients.clear();
+		return signals.empty();
+	}
+
+	unsigned int signalSize = signals.front()->Size();
+	unsigned int numChannels = static_cast<unsigned int>(signals.size());
+
+	std::vector<double> bins(frequencies.size());
+	for (size_t index = 0; index < frequencies.size(); ++index)
+	{
+		bins[index] = GetBinForFrequency(frequencies[index], signalSize, signals.front()->GetSamplingRate());
+	}
+
+	std::vector<const Complex*> channels(numChannels);
+	for (unsigned int channel = 0; channel < numChannels; ++channel)
+	{
+		channels[channel] = signals[channel]->_dataVec.data();
+	}
+
+	coefficients.resize(frequencies.size() * numChannels);
+
+	GoertzelBank bank(signalSize, bins);
+	bank.Execute(channels.data(), numChannels, coefficients.data());
+
+	for (auto& bin : coefficients)
+	{
+		bin.first /= (float)signalSize;
+		bin.second /= (float)signalSize;
+	}
+
+	return true;
+}
+
+//numBins coefficients evenly spaced over [startFrequency, endFrequency] Hz, scaled by 1/N same as FastFT
+//computed with chirp-Z transform so resolution is not limited to samplingRate / N, time slot holds frequency of bin
+RawSignalPtr ZoomFT(const RawSignalPtr& signal, float startFrequency, float endFrequency, unsigned int numBins)
+{
+	MeasureExecution<>  execution("ZoomFT");
+
+	unsigned int signalSize = signal->Size();
+	unsigned int samplingRate = signal->GetSamplingRate();
+
+	double startBin = GetBinForFrequency(startFrequency, signalSize, samplingRate);
+	double endBin = GetBinForFrequency(endFrequency, signalSize, samplingRate);
+	double binStep = numBins > 1 ? (endBin - startBin) / (numBins - 1) : 0.0;
+
+	RawSignalPtr result(new RawSignal(numBins, samplingRate));
+
+	ChirpZ chirpZ(signalSize, numBins, startBin, binStep);
+	chirpZ.Execute(signal->_dataVec.data(), result->_dataVec.data());
+
+	for (unsigned int index = 0; index < numBins; ++index)
+	{
+		result->_timeVec[index] = static_cast<float>((startBin + index * binStep) * samplingRate / signalSize);
+		result->_dataVec[index].first /= (float)signalSize;
+		result->_dataVec[index].second /= (float)signalSize;
+	}
+
+	return move(result);
+}
+
+//inverse of FastFT, uses cached inverse plan so it is O(N log N) instead of one complex sine per coefficient
+//coefficients are expected to be scaled by 1/N (FastFT, DiscreteFT) so no scaling is applied here
+RawSignalPtr InverseFastFT(const RawSignalPtr& fCoeeficients)
+{
+	MeasureExecution<>  execution("InverseFastFT");
+
+	unsigned int signalSize = fCoeeficients->Size();
+
+	RawSignalPtr reconstructedSignal(new RawSignal(signalSize, fCoeeficients->GetSamplingRate()));
+
+	reconstructedSignal->_timeVec = fCoeeficients->_timeVec;
+	reconstructedSignal->_dataVec = fCoeeficients->_dataVec;
+
+	FastFTImpl(reconstructedSignal->_dataVec, FftDirection::Inverse);
+
+	return reconstructedSignal;
+}
+
+//signal of signalSize samples from explicit list of nonzero coefficients scaled by 1/N (FastFT, DiscreteFT)
+//few coefficients are synthesized directly in O(N * K), denser lists go through inverse FFT, result has samplingRate
+RawSignalPtr SparseInverseFT(const std::vector<SparseCoefficient>& coefficients, unsigned int signalSize, unsigned int samplingRate = SamplingRate)
+{
+	MeasureExecution<>  execution("SparseInverseFT");
+
+	RawSignalPtr reconstructedSignal(new RawSignal(signalSize, samplingRate));
+
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		reconstructedSignal->_timeVec[index] = (float)index / reconstructedSignal->GetSamplingRate();
+	}
+
+	if (UseSparseSynthesis(coefficients.size(), signalSize))
+	{
+		SynthesizeSparse(coefficients, signalSize, reconstructedSignal->_dataVec.data());
+		return reconstructedSignal;
+	}
+
+	for (const auto& coefficient : coefficients)
+	{
+		//bins that alias onto same slot add up like they do in sparse synthesis
+		Complex& value = reconstructedSignal->_dataVec[coefficient.bin % signalSize];
+		value = { value.first + coefficient.value.first, value.second + coefficient.value.second };
+	}
+	FastFTImpl(reconstructedSignal->_dataVec, FftDirection::Inverse);
+
+	return reconstructedSignal;
+}
+
+//inverse of FastFT that checks how many coefficients are above threshold first,
+//mostly zero spectra (after filtering) are synthesized from nonzero bins only, others use InverseFastFT
+RawSignalPtr SparseInverseFT(const RawSignalPtr& fCoeeficients, float threshold = 0.f)
+{
+	MeasureExecution<>  execution("SparseInverseFT");
+
+	unsigned int signalSize = fCoeeficients->Size();
+
+	std::vector<SparseCoefficient> coefficients = ExtractSparseCoefficients(fCoeeficients->_dataVec.data(), signalSize, threshold);
+	if (!UseSparseSynthesis(coefficients.size(), signalSize))
+	{
+		return InverseFastFT(fCoeeficients);
+	}
+
+	RawSignalPtr reconstructedSignal(new RawSignal(signalSize, fCoeeficients->GetSamplingRate()));
+	reconstructedSignal->_timeVec = fCoeeficients->_timeVec;
+
+	SynthesizeSparse(coefficients, signalSize, reconstructedSignal->_dataVec.data());
+
+	return reconstructedSignal;
+}
+
+//FFT for real signals, imaginary part of input is ignored
+//returns only SignalSize/2 + 1 non redundant bins scaled by 1/N same as FastFT,
+//remaining bins are conjugates of returned ones: X[N-k] = conj(X[k])
+RawSignalPtr RealFastFT(const RawSignalPtr& signal)
+{
+	MeasureExecution<>  execution("RealFastFT");
+
+	unsigned int signalSize = signal->Size();
+	auto plan = GetRealFftPlan(signalSize);
+	unsigned int spectrumSize = plan->GetSpectrumSize();
+
+	RawSignalPtr result(new RawSignal(spectrumSize, signal->GetSamplingRate()));
+
+	std::vector<float> samples(signalSize);
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		samples[index] = signal->_dataVec[index].first;
+	}
+
+	plan->Forward(samples.data(), result->_dataVec.data());
+
+	for (unsigned int index = 0; index < spectrumSize; ++index)
+	{
+		result->_timeVec[index] = signal->_timeVec[index];
+		result->_dataVec[index].first /= (float)signalSize;
+		result->_dataVec[index].second /= (float)signalSize;
+	}
+
+	return move(result);
+}
+
+//reconstructs real signal of signalSize samples from half spectrum produced by RealFastFT
+RawSignalPtr InverseRealFastFT(const RawSignalPtr& halfSpectrum, unsigned int signalSize)
+{
+	MeasureExecution<>  execution("InverseRealFastFT");
+
+	auto plan = GetRealFftPlan(signalSize);
+
+	RawSignalPtr result(new RawSignal(signalSize, halfSpectrum->GetSamplingRate()));
+
+	std::vector<float> samples(signalSize);
+	plan->Inverse(halfSpectrum->_dataVec.data(), samples.data());
+
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		//FastFT scaling already happened in forward transform
+		result->_timeVec[index] = (float)index / result->GetSamplingRate();
+		result->_dataVec[index] = { samples[index], 0.f };
+	}
+
+	return result;
+}
+
+//spectra of windowed frames of frameSize samples taken every hop samples
+//every frame is scaled like FastFT, _timeVec of frame holds bin frequencies, frames are computed in parallel
+std::vector<Spectrum> ShortTimeFT(const RawSignalPtr& signal, unsigned int frameSize, unsigned int hop, WindowType window = WindowType::Hann)
+{
+	MeasureExecution<>  execution("ShortTimeFT");
+
+	Stft stft(frameSize, hop, window, 1);
+
+	unsigned int numFrames = stft.GetFrameCount(signal->Size());
+	std::vector<Complex> frames(static_cast<size_t>(numFrames) * frameSize);
+	stft.Execute(signal->_dataVec.data(), signal->Size(), frames.data());
+
+	std::vector<Spectrum> result;
+	result.reserve(numFrames);
+	for (unsigned int frame = 0; frame < numFrames; ++frame)
+	{
+		RawSignalPtr coefficients(new RawSignal(frameSize, signal->GetSamplingRate()));
+		std::copy(frames.begin() + static_cast<size_t>(frame) * frameSize, frames.begin() + static_cast<size_t>(frame + 1) * frameSize, coefficients->_dataVec.begin());
+		for (unsigned int bin = 0; bin < frameSize; ++bin)
+		{
+			coefficients->_timeVec[bin] = (float)bin * coefficients->GetSamplingRate() / frameSize;
+		}
+		result.emplace_back(move(coefficients));
+	}
+
+	return result;
+}
+
+//one sided power spectral density of real part of signal averaged over segments of segmentSize samples overlapping by overlap,
+//_timeVec holds frequency, real part holds power per hz, much smoother noise floor than single FastFT periodogram
+RawSignalPtr WelchPSD(const RawSignalPtr& signal, unsigned int segmentSize, unsigned int overlap, WindowType window = WindowType::Hann)
+{
+	MeasureExecution<>  execution("WelchPSD");
+
+	Welch welch(segmentSize, overlap, signal->GetSamplingRate(), window);
+	welch.Push(signal->_dataVec.data(), signal->Size());
+
+	unsigned int numBins = welch.GetNumBins();
+	std::vector<float> psd(numBins);
+	welch.GetPsd(psd.data());
+
+	RawSignalPtr result(new RawSignal(numBins, signal->GetSamplingRate()));
+	for (unsigned int bin = 0; bin < numBins; ++bin)
+	{
+		result->_timeVec[bin] = welch.GetBinFrequency(bin);
+		result->_dataVec[bin] = { psd[bin], 0.f };
+	}
+
+	return move(result);
+}
 
+//runs real and imaginary part of signal through filter as two channels
+RawSignalPtr FirOnSignal(const RawSignalPtr& signal, FirFilter& filter)
+{
 	unsigned int signalSize = signal->Size();
 
-	RawSignalPtr result(new RawSignal(signalSize));
+	std::vector<float> real(signalSize);
+	std::vector<float> img(signalSize);
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		real[index] = signal->_dataVec[index].first;
+		img[index] = signal->_dataVec[index].second;
+	}
+
+	unsigned int resultSize = filter.GetOutputCount(signalSize);
+	std::vector<float> realOutput(resultSize);
+	std::vector<float> imgOutput(resultSize);
+
+	const float* input[2] = { real.data(), img.data() };
+	float* output[2] = { realOutput.data(), imgOutput.data() };
+	filter.Process(input, signalSize, output);
+
+	//decimated rate is rounded down when it is not whole number
+	unsigned int samplingRate = signal->GetSamplingRate();
+	if (filter.GetMode() == FirMode::Decimate)
+	{
+		samplingRate /= filter.GetFactor();
+	}
+	else if (filter.GetMode() == FirMode::Interpolate)
+	{
+		samplingRate *= filter.GetFactor();
+	}
+
+	RawSignalPtr result(new RawSignal(resultSize, samplingRate));
+	for (unsigned int index = 0; index < resultSize; ++index)
+	{
+		result->_dataVec[index] = { realOutput[index], imgOutput[index] };
+	}
+
+	return move(result);
+}
+
+//causal FIR filter in time domain, output is delayed by group delay of taps ((numTaps - 1) / 2 for symmetric taps)
+//unlike zeroing FFT bins it does not ring over whole signal
+RawSignalPtr FirFiltering(const RawSignalPtr& signal, const std::vector<float>& taps)
+{
+	MeasureExecution<>  execution("FirFiltering");
 
+	FirFilter filter(taps, 2);
+	RawSignalPtr result = FirOnSignal(signal, filter);
 	result->_timeVec = signal->_timeVec;
-	result->_dataVec = FastFTImpl(signal->_dataVec);
 
-	for (unsigned int i = 0; i < signalSize; ++i)
+	return move(result);
+}
+
+//keeps every factor-th sample of filtered signal, taps should cut off below samplingRate / (2 * factor)
+RawSignalPtr FirDecimate(const RawSignalPtr& signal, const std::vector<float>& taps, unsigned int factor)
+{
+	MeasureExecution<>  execution("FirDecimate");
+
+	FirFilter filter(taps, 2, FirMode::Decimate, factor);
+	RawSignalPtr result = FirOnSignal(signal, filter);
+
+	for (unsigned int index = 0; index < result->Size(); ++index)
 	{
-		result->_dataVec[i].first /= (float)signalSize;
-		result->_dataVec[i].second /= (float)signalSize;
+		result->_timeVec[index] = signal->_timeVec[index * filter.GetFactor()];
 	}
 
 	return move(result);
 }
 
-//faster discrete FT works with compiled signals to skip memory allocation
-RawSignalPtr DiscreteFT2(const Signal& signal)
+//factor samples per input sample, taps are designed for factor times higher rate
+//and should cut off below samplingRate / 2 of input
+RawSignalPtr FirInterpolate(const RawSignalPtr& signal, const std::vector<float>& taps, unsigned int factor)
+{
+	MeasureExecution<>  execution("FirInterpolate");
+
+	FirFilter filter(taps, 2, FirMode::Interpolate, factor);
+	RawSignalPtr result = FirOnSignal(signal, filter);
+
+	float startTime = signal->Size() != 0 ? signal->_timeVec[0] : 0.f;
+	float step = 1.f / (signal->GetSamplingRate() * filter.GetFactor());
+	for (unsigned int index = 0; index < result->Size(); ++index)
+	{
+		result->_timeVec[index] = startTime + index * step;
+	}
+
+	return move(result);
+}
+
+//signal converted to samplingRate items per second with polyphase resampler, ratio is reduced to smallest up / down
+//output sample m is at time of first input plus m / samplingRate, group delay of filter is compensated
+RawSignalPtr Resample(const RawSignalPtr& signal, unsigned int samplingRate, unsigned int tapsPerPhase = 32)
+{
+	MeasureExecution<>  execution("Resample");
+
+	unsigned int signalSize = signal->Size();
+	PolyphaseResampler resampler(samplingRate, signal->GetSamplingRate(), 2, tapsPerPhase);
+
+	unsigned long long scaledSize = static_cast<unsigned long long>(signalSize) * resampler.GetUpFactor();
+	unsigned int resultSize = static_cast<unsigned int>((scaledSize + resampler.GetDownFactor() - 1) / resampler.GetDownFactor());
+
+	//zeros after signal push out outputs still waiting for group delay
+	unsigned int streamSize = signalSize + static_cast<unsigned int>(resampler.GetLatency()) + 1;
+	std::vector<float> real(streamSize, 0.f);
+	std::vector<float> img(streamSize, 0.f);
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		real[index] = signal->_dataVec[index].first;
+		img[index] = signal->_dataVec[index].second;
+	}
+
+	unsigned int outputSize = (std::max)(resampler.GetOutputCount(streamSize), resultSize);
+	std::vector<float> realOutput(outputSize, 0.f);
+	std::vector<float> imgOutput(outputSize, 0.f);
+
+	const float* input[2] = { real.data(), img.data() };
+	float* output[2] = { realOutput.data(), imgOutput.data() };
+	resampler.Process(input, streamSize, output);
+
+	RawSignalPtr result(new RawSignal(resultSize, samplingRate));
+	float startTime = signalSize != 0 ? signal->_timeVec[0] : 0.f;
+	for (unsigned int index = 0; index < resultSize; ++index)
+	{
+		result->_dataVec[index] = { realOutput[index], imgOutput[index] };
+		result->_timeVec[index] = startTime + (float)index / samplingRate;
+	}
+
+	return move(result);
+}
+
+//signals captured at sourceRate items per second, which need not be whole number (measured clock of device),
+//converted to samplingRate with farrow resampler, all signals run as channels of one resampler
+//output sample m is at time of first input plus m / samplingRate
+std::vector<RawSignalPtr> FarrowResampleSignals(const RawSignalPtr* signals, unsigned int numSignals, double sourceRate, unsigned int samplingRate)
+{
+	FarrowResampler resampler(sourceRate > 0.0 ? samplingRate / sourceRate : 1.0, 2 * numSignals);
+
+	unsigned int signalSize = 0;
+	for (unsigned int index = 0; index < numSignals; ++index)
+	{
+		signalSize = (std::max)(signalSize, signals[index]->Size());
+	}
+
+	//zeros after longest signal push out outputs still waiting for latency
+	unsigned int streamSize = signalSize + resampler.GetLatency() + 1;
+	std::vector<std::vector<float>> channels(2 * numSignals, std::vector<float>(streamSize, 0.f));
+	for (unsigned int index = 0; index < numSignals; ++index)
+	{
+		for (unsigned int item = 0; item < signals[index]->Size(); ++item)
+		{
+			channels[2 * index][item] = signals[index]->_dataVec[item].first;
+			channels[2 * index + 1][item] = signals[index]->_dataVec[item].second;
+		}
+	}
+
+	unsigned int outputSize = resampler.GetOutputCount(streamSize);
+	std::vector<std::vector<float>> outputChannels(2 * numSignals, std::vector<float>(outputSize));
+
+	std::vector<const float*> input(2 * numSignals);
+	std::vector<float*> output(2 * numSignals);
+	for (unsigned int channel = 0; channel < 2 * numSignals; ++channel)
+	{
+		input[channel] = channels[channel].data();
+		output[channel] = outputChannels[channel].data();
+	}
+	resampler.Process(input.data(), streamSize, output.data());
+
+	std::vector<RawSignalPtr> results;
+	for (unsigned int index = 0; index < numSignals; ++index)
+	{
+		const RawSignalPtr& signal = signals[index];
+
+		//outputs whose time lies within signal
+		unsigned int resultSize = signal->Size() != 0 ? static_cast<unsigned int>(floor((signal->Size() - 1) * resampler.GetRatio())) + 1 : 0;
+		resultSize = (std::min)(resultSize, outputSize);
+
+		RawSignalPtr result(new RawSignal(resultSize, samplingRate));
+		float startTime = signal->Size() != 0 ? signal->_timeVec[0] : 0.f;
+		for (unsigned int item = 0; item < resultSize; ++item)
+		{
+			result->_dataVec[item] = { outputChannels[2 * index][item], outputChannels[2 * index + 1][item] };
+			result->_timeVec[item] = startTime + (float)item / samplingRate;
+		}
+		results.push_back(move(result));
+	}
+
+	return results;
+}
+
+std::vector<RawSignalPtr> FarrowResampleBatch(const std::vector<RawSignalPtr>& signals, double sourceRate, unsigned int samplingRate)
+{
+	MeasureExecution<>  execution("FarrowResampleBatch");
+
+	return FarrowResampleSignals(signals.data(), static_cast<unsigned int>(signals.size()), sourceRate, samplingRate);
+}
+
+RawSignalPtr FarrowResample(const RawSignalPtr& signal, double sourceRate, unsigned int samplingRate)
+{
+	MeasureExecution<>  execution("FarrowResample");
+
+	return move(FarrowResampleSignals(&signal, 1, sourceRate, samplingRate).front());
+}
+
+//signal delayed by delay samples, which may be fraction of sample, latency of filter is compensated
+RawSignalPtr DelaySignal(const RawSignalPtr& signal, double delay)
+{
+	MeasureExecution<>  execution("DelaySignal");
+
+	unsigned int signalSize = signal->Size();
+	FractionalDelay delayLine(2, delay);
+	delayLine.SetDelay(0, delay);
+	delayLine.SetDelay(1, delay);
+
+	unsigned int latency = delayLine.GetLatency();
+	unsigned int streamSize = signalSize + latency;
+	std::vector<float> real(streamSize, 0.f);
+	std::vector<float> img(streamSize, 0.f);
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		real[index] = signal->_dataVec[index].first;
+		img[index] = signal->_dataVec[index].second;
+	}
+
+	const float* input[2] = { real.data(), img.data() };
+	float* output[2] = { real.data(), img.data() };
+	delayLine.Process(input, streamSize, output);
+
+	RawSignalPtr result(new RawSignal(signalSize, signal->GetSamplingRate()));
+	result->_timeVec = signal->_timeVec;
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		result->_dataVec[index] = { real[latency + index], img[latency + index] };
+	}
+
+	return move(result);
+}
+
+//next block of stream through cascade made for 2 channels (real and imaginary part), state stays in cascade
+RawSignalPtr BiquadFiltering(BiquadCascade& cascade, const RawSignalPtr& block)
+{
+	unsigned int blockSize = block->Size();
+
+	std::vector<float> real(blockSize);
+	std::vector<float> img(blockSize);
+	for (unsigned int index = 0; index < blockSize; ++index)
+	{
+		real[index] = block->_dataVec[index].first;
+		img[index] = block->_dataVec[index].second;
+	}
+
+	const float* input[2] = { real.data(), img.data() };
+	float* output[2] = { real.data(), img.data() };
+	cascade.ProcessParallel(input, blockSize, output);
+
+	RawSignalPtr result(new RawSignal(blockSize, block->GetSamplingRate()));
+	result->_timeVec = block->_timeVec;
+	for (unsigned int index = 0; index < blockSize; ++index)
+	{
+		result->_dataVec[index] = { real[index], img[index] };
+	}
+
+	return move(result);
+}
+
+//whole signal through cascade of sections, see DesignBiquadNotch and others
+RawSignalPtr BiquadFiltering(const RawSignalPtr& signal, const std::vector<BiquadSection>& sections)
+{
+	MeasureExecution<>  execution("BiquadFiltering");
+
+	BiquadCascade cascade(sections, 2);
+	return BiquadFiltering(cascade, signal);
+}
+
+//full linear convolution of signal with kernel, signal->Size() + kernel->Size() - 1 samples
+//overlap-save blocks with FFT size picked from kernel length, O(N log M) instead of O(N * M)
+RawSignalPtr FastConvolution(const RawSignalPtr& signal, const RawSignalPtr& kernel)
+{
+	MeasureExecution<>  execution("FastConvolution");
+
+	unsigned int signalSize = signal->Size();
+	unsigned int kernelSize = kernel->Size();
+	unsigned int resultSize = signalSize != 0 && kernelSize != 0 ? signalSize + kernelSize - 1 : 0;
+
+	RawSignalPtr result(new RawSignal(resultSize, signal->GetSamplingRate()));
+
+	FftConvolver convolver(kernel->_dataVec.data(), kernelSize, FftConvolver::ChooseFftSize(kernelSize, signalSize));
+	convolver.Convolve(signal->_dataVec.data(), signalSize, result->_dataVec.data());
+
+	for (unsigned int index = 0; index < resultSize; ++index)
+	{
+		result->_timeVec[index] = (float)index / result->GetSamplingRate();
+	}
+
+	return move(result);
+}
+
+//same result as FastConvolution computed the way live stream is, block of blockSize samples at a time
+//with partitioned convolver, maxBlockSize above blockSize enables non-uniform partitions
+RawSignalPtr PartitionedConvolution(const RawSignalPtr& signal, const RawSignalPtr& kernel, unsigned int blockSize = 64, unsigned int maxBlockSize = 0)
+{
+	MeasureExecution<>  execution("PartitionedConvolution");
+
+	unsigned int signalSize = signal->Size();
+	unsigned int kernelSize = kernel->Size();
+	unsigned int resultSize = signalSize != 0 && kernelSize != 0 ? signalSize + kernelSize - 1 : 0;
+
+	RawSignalPtr result(new RawSignal(resultSize, signal->GetSamplingRate()));
+
+	PartitionedConvolver convolver(kernel->_dataVec.data(), kernelSize, blockSize, maxBlockSize);
+	unsigned int latency = convolver.GetLatency();
+
+	//zeros after signal push out kernel tail and latency
+	std::vector<Complex> stream(resultSize + latency, Complex{ 0.f, 0.f });
+	std::copy(signal->_dataVec.begin(), signal->_dataVec.begin() + (std::min)(signalSize, resultSize), stream.begin());
+
+	for (unsigned int done = 0; done < stream.size(); done += convolver.GetBlockSize())
+	{
+		unsigned int count = (std::min)(convolver.GetBlockSize(), static_cast<unsigned int>(stream.size()) - done);
+		convolver.Process(stream.data() + done, count, stream.data() + done);
+	}
+
+	for (unsigned int index = 0; index < resultSize; ++index)
+	{
+		result->_dataVec[index] = stream[latency + index];
+		result->_timeVec[index] = (float)index / result->GetSamplingRate();
+	}
+
+	return move(result);
+}
+
+//cross correlation r[l] = sum signal1[n+l] * conj(signal2[n]) for lags -(signal2->Size()-1)..(signal1->Size()-1)
+//_timeVec holds lag in seconds, same engine as FastConvolution with reversed conjugated signal2 as kernel
+RawSignalPtr FastCrossCorrelation(const RawSignalPtr& signal1, const RawSignalPtr& signal2)
+{
+	MeasureExecution<>  execution("FastCrossCorrelation");
+
+	unsigned int signalSize = signal1->Size();
+	unsigned int referenceSize = signal2->Size();
+	unsigned int resultSize = signalSize != 0 && referenceSize != 0 ? signalSize + referenceSize - 1 : 0;
+
+	RawSignalPtr result(new RawSignal(resultSize, signal1->GetSamplingRate()));
+
+	FftConvolver correlator = FftConvolver::Correlator(signal2->_dataVec.data(), referenceSize, FftConvolver::ChooseFftSize(referenceSize, signalSize));
+	correlator.Convolve(signal1->_dataVec.data(), signalSize, result->_dataVec.data());
+
+	for (unsigned int index = 0; index < resultSize; ++index)
+	{
+		int lag = static_cast<int>(index) - static_cast<int>(referenceSize - 1);
+		result->_timeVec[index] = (float)lag / result->GetSamplingRate();
+	}
+
+	return move(result);
+}
+
+//auto correlation for lags -(N-1)..(N-1), zero lag is in the middle
+RawSignalPtr FastAutoCorrelation(const RawSignalPtr& signal)
+{
+	return FastCrossCorrelation(signal, signal);
+}
+
+//discrete FT of numBins bins from firstBin of real part of compiled signal, scaled by 1/N
+//signal is sampled once, bins come from pruned DFT so no complex sine is built per bin
+RawSignalPtr DiscreteFT2(const Signal& signal, unsigned int firstBin, unsigned int numBins)
 {
 	MeasureExecution<> execution("DiscreteFT2");
 	unsigned int signalSize = signal.GetSize();
 
-	//create raw Signal
-	RawSignalPtr result(new RawSignal(signalSize));
-
+	std::vector<float> samples(signalSize);
 	for (unsigned int index = 0; index < signalSize; ++index)
 	{
-		//create complex sine wave
-		float frequency = (float)(index);
-		//TODO see if time scale is different for To raw signal than to evaluate
-		//TODO time normalization for ComplexSineSignal
-		auto& csw = ComplexSineSignal(-1.f, frequency, 0.f, signal.GetLenght());
+		samples[index] = signal.Evaluate(signal.GetTime(index));
+	}
 
-		result->_timeVec[index] = signal.GetTime(index);
-		//compute dot product
-		result->_dataVec[index] = RawSignalDot2(signal, csw);
+	//create raw Signal
+	RawSignalPtr result(new RawSignal(numBins, signal.GetSamplingRate()));
+
+	PrunedDft dft(signalSize, firstBin, numBins);
+	dft.Execute(samples.data(), result->_dataVec.data());
+
+	for (unsigned int index = 0; index < numBins; ++index)
+	{
+		result->_timeVec[index] = signal.GetTime(firstBin + index);
+		result->_dataVec[index].first /= (float)signalSize;
+		result->_dataVec[index].second /= (float)signalSize;
 	}
 
 	return move(result);
 }
 
+//faster discrete FT works with compiled signals to skip memory allocation
+RawSignalPtr DiscreteFT2(const Signal& signal)
+{
+	return DiscreteFT2(signal, 0, signal.GetSize());
+}
+
 RawSignalPtr GetAmplitudesFromSignals(const RawSignalPtr& signal)
 {
 	//create raw Signal
-	RawSignalPtr result(new RawSignal(signal->Size()));
+	RawSignalPtr result(new RawSignal(signal->Size(), signal->GetSamplingRate()));
 
 	for (unsigned int index = 0; index < signal->Size(); ++index)
 	{
@@ -216,7 +937,7 @@ RawSignalPtr InverseFT(const RawSignalPtr& fCoeeficients)
 	unsigned int signalSize = fCoeeficients->Size();
 	unsigned int samplingRate = fCoeeficients->GetSamplingRate();
 
-	RawSignalPtr reconstructedSignal(new RawSignal(signalSize));
+	RawSignalPtr reconstructedSignal(new RawSignal(signalSize, samplingRate));
 
 	for (unsigned int index = 0; index < signalSize; ++index)
 	{
@@ -226,7 +947,7 @@ RawSignalPtr InverseFT(const RawSignalPtr& fCoeeficients)
 		//get amplitude from fourier coeeficients
 		auto fCoefficient = fCoeeficients->_dataVec[index];
 
-		auto csw = ComplexSineSignal(1.f, frequency, 0.f, signalSize / samplingRate).ToRawSignalAndMultiply(fCoefficient);
+		auto csw = ComplexSineSignal(1.f, frequency, 0.f, signalSize / samplingRate).ToRawSignalAndMultiply(fCoefficient, signalSize);
 
 		//sum signals	
 		reconstructedSignal = AddSignals(reconstructedSignal, csw);
@@ -243,7 +964,7 @@ RawSignalPtr InverseFT2(const RawSignalPtr& fCoeeficients)
 	unsigned int signalSize = fCoeeficients->Size();
 	unsigned int signalLenghtSeconds = fCoeeficients->GetLenght();
 
-	RawSignalPtr reconstructedSignal(new RawSignal(signalSize));
+	RawSignalPtr reconstructedSignal(new RawSignal(signalSize, fCoeeficients->GetSamplingRate()));
 
 	for (unsigned int index = 0; index < signalSize; ++index)
 	{
@@ -255,10 +976,11 @@ RawSignalPtr InverseFT2(const RawSignalPtr& fCoeeficients)
 
 		Signal& csw = ComplexSineSignal(1.f, frequency, 0.f, signalLenghtSeconds);// .ToRawSignalAndMultiply(fCoefficient);
 
-		//multiply complex sine wave by fourier coefficient and add to signal
+		//multiply complex sine wave by fourier coefficient and add to signal, one period over signalSize items
 		for (unsigned int index = 0; index < signalSize; ++index)
 		{
-			std::pair<float, float> cswValue{ csw.Evaluate(index), csw.Evaluate2(index) };
+			float time = (float)index / signalSize;
+			std::pair<float, float> cswValue{ csw.Evaluate(time), csw.Evaluate2(time) };
 			auto cswMultiplied = ComplexMultiply(cswValue, fCoefficient);
 
 			reconstructedSignal->_dataVec[index].first += cswMultiplied.first;
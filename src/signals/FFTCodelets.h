@@ -0,0 +1,211 @@
+#pragma once
+#include <utility>
+#include <cstddef>
+
+//fully unrolled power of two FFTs for small fixed sizes
+//every butterfly is its own template instance with twiddle computed at compile time, so codelet is straight
+//line code without loops, index math or table reads, sign is -1 for forward and 1 for inverse kernel
+
+//codelet pieces are forced inline so whole transform ends up as one function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIGNALS_CODELET_INLINE __forceinline
+#else
+#define SIGNALS_CODELET_INLINE inline __attribute__((always_inline))
+#endif
+
+//sizes up to this one have codelet that FftPlanT can pick at runtime
+const unsigned int maxFftCodeletSize = 64;
+
+//taylor series, good to double precision for |x| <= PI which covers every codelet twiddle
+constexpr double CodeletSin(double x)
+{
+	double term = x;
+	double sum = x;
+	for (int index = 1; index < 30; ++index)
+	{
+		term *= -x * x / ((2.0 * index) * (2.0 * index + 1.0));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr double CodeletCos(double x)
+{
+	double term = 1.0;
+	double sum = 1.0;
+	for (int index = 1; index < 30; ++index)
+	{
+		term *= -x * x / ((2.0 * index - 1.0) * (2.0 * index));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr unsigned int CodeletBitReverse(unsigned int index, unsigned int size)
+{
+	unsigned int reversed = 0;
+	for (unsigned int bit = 1; bit < size; bit <<= 1)
+	{
+		reversed = (reversed << 1) | (index & 1u);
+		index >>= 1;
+	}
+	return reversed;
+}
+
+//butterfly K of last stage of N point transform, tag selects trivial twiddles
+//0: W = 1, 1: W = sign * i, 2: general twiddle
+template<unsigned int N, int Sign, unsigned int K, typename Real>
+SIGNALS_CODELET_INLINE void CodeletButterfly(std::pair<Real, Real>* data, std::integral_constant<int, 0>)
+{
+	std::pair<Real, Real> even = data[K];
+	std::pair<Real, Real> odd = data[K + N / 2];
+
+	data[K] = { even.first + odd.first, even.second + odd.second };
+	data[K + N / 2] = { even.first - odd.first, even.second - odd.second };
+}
+
+template<unsigned int N, int Sign, unsigned int K, typename Real>
+SIGNALS_CODELET_INLINE void CodeletButterfly(std::pair<Real, Real>* data, std::integral_constant<int, 1>)
+{
+	std::pair<Real, Real> even = data[K];
+	std::pair<Real, Real> odd = data[K + N / 2];
+	Real rotatedReal = -Sign * odd.second;
+	Real rotatedImg = Sign * odd.first;
+
+	data[K] = { even.first + rotatedReal, even.second + rotatedImg };
+	data[K + N / 2] = { even.first - rotatedReal, even.second - rotatedImg };
+}
+
+template<unsigned int N, int Sign, unsigned int K, typename Real>
+SIGNALS_CODELET_INLINE void CodeletButterfly(std::pair<Real, Real>* data, std::integral_constant<int, 2>)
+{
+	constexpr double angle = Sign * 6.283185307179586476925 * K / N;
+	constexpr Real twiddleReal = static_cast<Real>(CodeletCos(angle));
+	constexpr Real twiddleImg = static_cast<Real>(CodeletSin(angle));
+
+	std::pair<Real, Real> even = data[K];
+	std::pair<Real, Real> odd = data[K + N / 2];
+	Real rotatedReal = odd.first * twiddleReal - odd.second * twiddleImg;
+	Real rotatedImg = odd.first * twiddleImg + odd.second * twiddleReal;
+
+	data[K] = { even.first + rotatedReal, even.second + rotatedImg };
+	data[K + N / 2] = { even.first - rotatedReal, even.second - rotatedImg };
+}
+
+//butterflies 0..K of last stage
+template<unsigned int N, int Sign, unsigned int K, typename Real>
+struct CodeletCombine
+{
+	SIGNALS_CODELET_INLINE static void Run(std::pair<Real, Real>* data)
+	{
+		CodeletCombine<N, Sign, K - 1, Real>::Run(data);
+		CodeletButterfly<N, Sign, K>(data, std::integral_constant<int, (4 * K == N) ? 1 : 2>());
+	}
+};
+
+template<unsigned int N, int Sign, typename Real>
+struct CodeletCombine<N, Sign, 0, Real>
+{
+	SIGNALS_CODELET_INLINE static void Run(std::pair<Real, Real>* data)
+	{
+		CodeletButterfly<N, Sign, 0>(data, std::integral_constant<int, 0>());
+	}
+};
+
+//decimation in time on bit reversed data, both halves first and then last stage
+template<unsigned int N, int Sign, typename Real>
+struct CodeletButterflies
+{
+	SIGNALS_CODELET_INLINE static void Run(std::pair<Real, Real>* data)
+	{
+		CodeletButterflies<N / 2, Sign, Real>::Run(data);
+		CodeletButterflies<N / 2, Sign, Real>::Run(data + N / 2);
+		CodeletCombine<N, Sign, N / 2 - 1, Real>::Run(data);
+	}
+};
+
+template<int Sign, typename Real>
+struct CodeletButterflies<1, Sign, Real>
+{
+	SIGNALS_CODELET_INLINE static void Run(std::pair<Real, Real>*)
+	{
+	}
+};
+
+//output[bitreverse(I)] = input[I * stride] for I = 0..Count-1
+template<unsigned int N, unsigned int Count, typename Real>
+struct CodeletPermute
+{
+	SIGNALS_CODELET_INLINE static void Run(const std::pair<Real, Real>* input, size_t stride, std::pair<Real, Real>* output)
+	{
+		CodeletPermute<N, Count - 1, Real>::Run(input, stride, output);
+		output[CodeletBitReverse(Count - 1, N)] = input[(Count - 1) * stride];
+	}
+};
+
+template<unsigned int N, typename Real>
+struct CodeletPermute<N, 0, Real>
+{
+	SIGNALS_CODELET_INLINE static void Run(const std::pair<Real, Real>*, size_t, std::pair<Real, Real>*)
+	{
+	}
+};
+
+//N point transform usable on its own, no 1/N scaling, input and output must not overlap
+template<unsigned int N, typename Real = float>
+class FixedFft
+{
+	static_assert(N >= 1 && (N & (N - 1)) == 0, "FixedFft size has to be power of two");
+
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	static unsigned int GetSize()
+	{
+		return N;
+	}
+
+	//input items are read with given stride, output is contiguous
+	static void Forward(const ComplexT* input, ComplexT* output, size_t stride = 1)
+	{
+		CodeletPermute<N, N, Real>::Run(input, stride, output);
+		CodeletButterflies<N, -1, Real>::Run(output);
+	}
+
+	static void Inverse(const ComplexT* input, ComplexT* output, size_t stride = 1)
+	{
+		CodeletPermute<N, N, Real>::Run(input, stride, output);
+		CodeletButterflies<N, 1, Real>::Run(output);
+	}
+
+	//in place transform of data already in bit reversed order, used as leaf of bigger transforms
+	static void ForwardBitReversed(ComplexT* data)
+	{
+		CodeletButterflies<N, -1, Real>::Run(data);
+	}
+
+	static void InverseBitReversed(ComplexT* data)
+	{
+		CodeletButterflies<N, 1, Real>::Run(data);
+	}
+};
+
+template<typename Real>
+using FftCodelet = void(*)(std::pair<Real, Real>*);
+
+//bit reversed codelet for runtime size, nullptr when size has no codelet
+template<typename Real>
+FftCodelet<Real> GetFftCodelet(unsigned int size, bool inverse)
+{
+	switch (size)
+	{
+	case 1: return inverse ? &FixedFft<1, Real>::InverseBitReversed : &FixedFft<1, Real>::ForwardBitReversed;
+	case 2: return inverse ? &FixedFft<2, Real>::InverseBitReversed : &FixedFft<2, Real>::ForwardBitReversed;
+	case 4: return inverse ? &FixedFft<4, Real>::InverseBitReversed : &FixedFft<4, Real>::ForwardBitReversed;
+	case 8: return inverse ? &FixedFft<8, Real>::InverseBitReversed : &FixedFft<8, Real>::ForwardBitReversed;
+	case 16: return inverse ? &FixedFft<16, Real>::InverseBitReversed : &FixedFft<16, Real>::ForwardBitReversed;
+	case 32: return inverse ? &FixedFft<32, Real>::InverseBitReversed : &FixedFft<32, Real>::ForwardBitReversed;
+	case 64: return inverse ? &FixedFft<64, Real>::InverseBitReversed : &FixedFft<64, Real>::ForwardBitReversed;
+	default: return nullptr;
+	}
+}
\ No newline at end of file
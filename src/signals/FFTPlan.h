@@ -0,0 +1,735 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <math.h>
+#include "SimdKernels.h"
+#include "FFTCodelets.h"
+
+enum class FftDirection
+{
+	Forward,	//exp(-2*PI*i*k*n/N) kernel
+	Inverse		//exp(+2*PI*i*k*n/N) kernel, no 1/N scaling
+};
+
+enum class FftAlgorithm
+{
+	Radix2,		//power of two sizes, bit reversal, unrolled leaf codelets and radix-4 passes
+	MixedRadix,	//sizes made of 2, 3, 4, 5, 7 factors, Stockham autosort stages
+	Bluestein	//any other size, chirp convolution done with power of two plans
+};
+
+template<typename Real>
+class FftPlanT;
+
+template<typename Real>
+using FftPlanPtr = std::shared_ptr<const FftPlanT<Real>>;
+
+template<typename Real = float>
+FftPlanPtr<Real> GetFftPlan(unsigned int size, FftDirection direction = FftDirection::Forward);
+
+//precomputed FFT for one transform size and direction
+//twiddles, permutation and sub plans are built once in constructor,
+//Execute is const and does not allocate when scratch is passed so one plan can be shared by many threads
+template<typename Real>
+class FftPlanT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	FftPlanT(unsigned int size, FftDirection direction) :
+		_size(size),
+		_direction(direction)
+	{
+		if (IsPowerOfTwo(size) || size <= 1)
+		{
+			_algorithm = FftAlgorithm::Radix2;
+			BuildPermutation();
+			BuildTwiddles();
+			BuildLeaves();
+		}
+		else if (Factorize(size, _radices))
+		{
+			_algorithm = FftAlgorithm::MixedRadix;
+			BuildStages();
+		}
+		else
+		{
+			_algorithm = FftAlgorithm::Bluestein;
+			BuildBluestein();
+		}
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	FftDirection GetDirection() const
+	{
+		return _direction;
+	}
+
+	FftAlgorithm GetAlgorithm() const
+	{
+		return _algorithm;
+	}
+
+	//every size is supported, non power of two sizes need scratch buffer
+	static bool IsSupportedSize(unsigned int size)
+	{
+		return size != 0;
+	}
+
+	static bool IsPowerOfTwo(unsigned int size)
+	{
+		return size != 0 && (size & (size - 1)) == 0;
+	}
+
+	//number of items Execute needs in scratch buffer, 0 for power of two sizes
+	unsigned int GetScratchSize() const
+	{
+		switch (_algorithm)
+		{
+		case FftAlgorithm::MixedRadix:
+			return _size;
+		case FftAlgorithm::Bluestein:
+			return _convolutionSize;
+		default:
+			return 0;
+		}
+	}
+
+	//in place transform of GetSize() items, scratch has GetScratchSize() items
+	//named apart from out of place Execute(input, output) so non-const input cannot pick wrong overload
+	void ExecuteInPlace(ComplexT* data, ComplexT* scratch) const
+	{
+		switch (_algorithm)
+		{
+		case FftAlgorithm::Radix2:
+			if (UseSplitKernels())
+			{
+				RunSplit(data, data);
+				break;
+			}
+			PermuteInPlace(data);
+			RunLeaves(data);
+			RunButterflies(data, _leafSize);
+			break;
+		case FftAlgorithm::MixedRadix:
+			RunStages(data, scratch);
+			break;
+		case FftAlgorithm::Bluestein:
+			RunBluestein(data, scratch);
+			break;
+		}
+	}
+
+	//in place transform with per thread scratch buffer
+	void Execute(ComplexT* data) const
+	{
+		if (_algorithm == FftAlgorithm::Radix2)
+		{
+			ExecuteInPlace(data, nullptr);
+			return;
+		}
+
+		thread_local std::vector<ComplexT> scratch;
+		if (scratch.size() < GetScratchSize())
+		{
+			scratch.resize(GetScratchSize());
+		}
+
+		ExecuteInPlace(data, scratch.data());
+	}
+
+	//out of place transform, input and output must not overlap
+	void Execute(const ComplexT* input, ComplexT* output) const
+	{
+		if (_algorithm == FftAlgorithm::Radix2)
+		{
+			if (UseSplitKernels())
+			{
+				RunSplit(input, output);
+				return;
+			}
+
+			for (unsigned int index = 0; index < _size; ++index)
+			{
+				output[_permutation[index]] = input[index];
+			}
+
+			RunLeaves(output);
+			RunButterflies(output, _leafSize);
+			return;
+		}
+
+		std::copy(input, input + _size, output);
+		Execute(output);
+	}
+
+	//out of place transform of input[n] * window[n], window is applied while input is gathered into bit reversed order
+	//so windowing needs no extra pass over memory, other algorithms multiply into output first
+	void ExecuteWindowed(const ComplexT* input, const Real* window, ComplexT* output) const
+	{
+		if (_algorithm == FftAlgorithm::Radix2)
+		{
+			if (UseSplitKernels())
+			{
+				RunSplit(input, output, window);
+				return;
+			}
+
+			for (unsigned int index = 0; index < _size; ++index)
+			{
+				output[_permutation[index]] = { input[index].first * window[index], input[index].second * window[index] };
+			}
+
+			RunLeaves(output);
+			RunButterflies(output, _leafSize);
+			return;
+		}
+
+		WindowMultiply(input, window, output, _size);
+		Execute(output);
+	}
+
+	void Execute(std::vector<ComplexT>& data) const
+	{
+		Execute(data.data());
+	}
+
+	//in place transform of split complex data, real and imaginary parts in separate arrays
+	//power of two sizes run vectorized butterflies directly on the arrays
+	void ExecuteSplit(Real* re, Real* im) const
+	{
+		if (_algorithm == FftAlgorithm::Radix2)
+		{
+			for (unsigned int index = 0; index < _size; ++index)
+			{
+				unsigned int reversed = _permutation[index];
+				if (index < reversed)
+				{
+					std::swap(re[index], re[reversed]);
+					std::swap(im[index], im[reversed]);
+				}
+			}
+
+			SplitButterflies(re, im, _size, GetSplitTwiddles());
+			return;
+		}
+
+		thread_local std::vector<ComplexT> interleaved;
+		interleaved.resize(_size);
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			interleaved[index] = { re[index], im[index] };
+		}
+
+		Execute(interleaved.data());
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			re[index] = interleaved[index].first;
+			im[index] = interleaved[index].second;
+		}
+	}
+
+private:
+	struct Stage
+	{
+		unsigned int radix;
+		unsigned int stride;			//s, product of radices of previous stages
+		unsigned int count;				//m, size of remaining sub transforms
+		unsigned int twiddleOffset;
+	};
+
+	//splits size into supported radices, 4 first so power of two parts need fewer passes
+	static bool Factorize(unsigned int size, std::vector<unsigned int>& radices)
+	{
+		const unsigned int supported[] = { 4, 2, 3, 5, 7 };
+
+		radices.clear();
+		for (unsigned int radix : supported)
+		{
+			while (size % radix == 0)
+			{
+				radices.push_back(radix);
+				size /= radix;
+			}
+		}
+
+		return size == 1;
+	}
+
+	void BuildPermutation()
+	{
+		_permutation.resize(_size);
+
+		unsigned int numBits = 0;
+		while ((1u << numBits) < _size)
+		{
+			++numBits;
+		}
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			unsigned int reversed = 0;
+			for (unsigned int bit = 0; bit < numBits; ++bit)
+			{
+				reversed |= ((index >> bit) & 1u) << (numBits - 1 - bit);
+			}
+			_permutation[index] = reversed;
+		}
+	}
+
+	double GetSign() const
+	{
+		return _direction == FftDirection::Forward ? -1.0 : 1.0;
+	}
+
+	static ComplexT Polar(double angle)
+	{
+		//computed in double so large sizes do not lose precision
+		return { static_cast<Real>(cos(angle)), static_cast<Real>(sin(angle)) };
+	}
+
+	void BuildTwiddles()
+	{
+		//split tables start stage at offset halfStage so vector loads of wide stages stay aligned,
+		//interleaved butterflies read same tables
+		BuildSplitTwiddles(_size, GetSign(), _splitTwiddleRe, _splitTwiddleIm, _splitCubeRe, _splitCubeIm);
+	}
+
+	SplitTwiddles<Real> GetSplitTwiddles() const
+	{
+		return { _splitTwiddleRe.data(), _splitTwiddleIm.data(), _splitCubeRe.data(), _splitCubeIm.data(), static_cast<Real>(GetSign()) };
+	}
+
+	//first stages of power of two transform run as unrolled codelets on bit reversed blocks,
+	//sizes with own codelet are done by it completely
+	void BuildLeaves()
+	{
+		const unsigned int leafCodeletSize = 16;
+
+		_leafSize = _size <= maxFftCodeletSize ? _size : leafCodeletSize;
+		_leafCodelet = GetFftCodelet<Real>(_leafSize, _direction == FftDirection::Inverse);
+	}
+
+	void RunLeaves(ComplexT* data) const
+	{
+		if (_leafCodelet == nullptr)
+		{
+			return;
+		}
+
+		for (unsigned int blockStart = 0; blockStart < _size; blockStart += _leafSize)
+		{
+			_leafCodelet(data + blockStart);
+		}
+	}
+
+	//vector kernels pay off once data is deinterleaved anyway, sizes with own codelet stay interleaved
+	bool UseSplitKernels() const
+	{
+		return _size > maxFftCodeletSize && HasSimdButterflies<Real>();
+	}
+
+	//bit reversal and leaf codelets are folded into deinterleave, remaining butterflies run on split arrays
+	//and result is interleaved back
+	//input and output may be the same buffer
+	void RunSplit(const ComplexT* input, ComplexT* output, const Real* window = nullptr) const
+	{
+		thread_local AlignedVector<Real> re;
+		thread_local AlignedVector<Real> im;
+		if (re.size() < _size)
+		{
+			re.resize(_size);
+			im.resize(_size);
+		}
+
+		//permutation is its own inverse so block items can be gathered
+		ComplexT leaf[maxFftCodeletSize];
+		for (unsigned int blockStart = 0; blockStart < _size; blockStart += _leafSize)
+		{
+			if (window == nullptr)
+			{
+				for (unsigned int index = 0; index < _leafSize; ++index)
+				{
+					leaf[index] = input[_permutation[blockStart + index]];
+				}
+			}
+			else
+			{
+				for (unsigned int index = 0; index < _leafSize; ++index)
+				{
+					unsigned int source = _permutation[blockStart + index];
+					leaf[index] = { input[source].first * window[source], input[source].second * window[source] };
+				}
+			}
+
+			_leafCodelet(leaf);
+
+			for (unsigned int index = 0; index < _leafSize; ++index)
+			{
+				re[blockStart + index] = leaf[index].first;
+				im[blockStart + index] = leaf[index].second;
+			}
+		}
+
+		SplitButterflies(re.data(), im.data(), _size, GetSplitTwiddles(), _leafSize);
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			output[index] = { re[index], im[index] };
+		}
+	}
+
+	void BuildStages()
+	{
+		const double twoPi = 6.283185307179586476925;
+
+		unsigned int remaining = _size;
+		unsigned int stride = 1;
+
+		for (unsigned int radix : _radices)
+		{
+			unsigned int count = remaining / radix;
+
+			Stage stage{ radix, stride, count, static_cast<unsigned int>(_twiddles.size()) };
+
+			//stage output t of sub transform q is rotated by exp(sign*2*PI*i*q*t/remaining)
+			for (unsigned int q = 0; q < count; ++q)
+			{
+				for (unsigned int t = 1; t < radix; ++t)
+				{
+					_twiddles.push_back(Polar(GetSign() * twoPi * q * t / remaining));
+				}
+			}
+
+			_stages.push_back(stage);
+
+			remaining = count;
+			stride *= radix;
+		}
+
+		//roots used by generic small DFT kernels
+		for (unsigned int radix = 0; radix < 8; ++radix)
+		{
+			_radixRoots[radix].clear();
+			for (unsigned int j = 0; j < radix; ++j)
+			{
+				_radixRoots[radix].push_back(Polar(GetSign() * twoPi * j / radix));
+			}
+		}
+	}
+
+	void BuildBluestein()
+	{
+		const double pi = 3.141592653589793238462;
+
+		_convolutionSize = 1;
+		while (_convolutionSize < 2 * _size - 1)
+		{
+			_convolutionSize <<= 1;
+		}
+
+		//chirp w[n] = exp(sign*PI*i*n^2/N), n^2 is reduced modulo 2N so angle stays small
+		_chirp.resize(_size);
+		for (unsigned int n = 0; n < _size; ++n)
+		{
+			unsigned long long square = (static_cast<unsigned long long>(n) * n) % (2ull * _size);
+			_chirp[n] = Polar(GetSign() * pi * static_cast<double>(square) / _size);
+		}
+
+		//spectrum of conjugated chirp, 1/M of inverse convolution transform is folded in
+		_forwardConvolution = GetFftPlan<Real>(_convolutionSize, FftDirection::Forward);
+		_inverseConvolution = GetFftPlan<Real>(_convolutionSize, FftDirection::Inverse);
+
+		_chirpSpectrum.assign(_convolutionSize, { Real(0), Real(0) });
+		Real scale = Real(1) / _convolutionSize;
+		for (unsigned int n = 0; n < _size; ++n)
+		{
+			ComplexT conjugated{ _chirp[n].first * scale, -_chirp[n].second * scale };
+			_chirpSpectrum[n] = conjugated;
+			if (n != 0)
+			{
+				_chirpSpectrum[_convolutionSize - n] = conjugated;
+			}
+		}
+
+		_forwardConvolution->ExecuteInPlace(_chirpSpectrum.data(), nullptr);
+	}
+
+	void PermuteInPlace(ComplexT* data) const
+	{
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			unsigned int reversed = _permutation[index];
+			if (index < reversed)
+			{
+				std::swap(data[index], data[reversed]);
+			}
+		}
+	}
+
+	//radix-4 passes on bit reversed data from firstHalfStage on, each one does work of two radix-2 stages
+	//with 3 complex multiplies per 4 items instead of 4, odd number of stages ends with one radix-2 stage
+	void RunButterflies(ComplexT* data, unsigned int firstHalfStage) const
+	{
+		const SplitTwiddles<Real> twiddles = GetSplitTwiddles();
+
+		unsigned int halfStage = firstHalfStage;
+		for (; halfStage * 2 < _size; halfStage <<= 2)
+		{
+			const Real* w1r = twiddles.re + 2 * halfStage;
+			const Real* w1i = twiddles.im + 2 * halfStage;
+			const Real* w2r = twiddles.re + halfStage;
+			const Real* w2i = twiddles.im + halfStage;
+			const Real* w3r = twiddles.cubeRe + halfStage;
+			const Real* w3i = twiddles.cubeIm + halfStage;
+
+			for (unsigned int blockStart = 0; blockStart < _size; blockStart += 4 * halfStage)
+			{
+				ComplexT* x0 = data + blockStart;
+				ComplexT* x1 = x0 + halfStage;
+				ComplexT* x2 = x1 + halfStage;
+				ComplexT* x3 = x2 + halfStage;
+
+				for (unsigned int k = 0; k < halfStage; ++k)
+				{
+					ComplexT u1 = Multiply(x1[k], { w2r[k], w2i[k] });
+					ComplexT u2 = Multiply(x2[k], { w1r[k], w1i[k] });
+					ComplexT u3 = Multiply(x3[k], { w3r[k], w3i[k] });
+
+					Real sumReal = x0[k].first + u1.first, sumImg = x0[k].second + u1.second;
+					Real diffReal = x0[k].first - u1.first, diffImg = x0[k].second - u1.second;
+					Real pairReal = u2.first + u3.first, pairImg = u2.second + u3.second;
+					//(u2 - u3) * W_4
+					Real rotatedReal = -twiddles.rotation * (u2.second - u3.second);
+					Real rotatedImg = twiddles.rotation * (u2.first - u3.first);
+
+					x0[k] = { sumReal + pairReal, sumImg + pairImg };
+					x2[k] = { sumReal - pairReal, sumImg - pairImg };
+					x1[k] = { diffReal + rotatedReal, diffImg + rotatedImg };
+					x3[k] = { diffReal - rotatedReal, diffImg - rotatedImg };
+				}
+			}
+		}
+
+		if (halfStage < _size)
+		{
+			const Real* wr = twiddles.re + halfStage;
+			const Real* wi = twiddles.im + halfStage;
+
+			ComplexT* even = data;
+			ComplexT* odd = data + halfStage;
+			for (unsigned int k = 0; k < halfStage; ++k)
+			{
+				ComplexT rotated = Multiply(odd[k], { wr[k], wi[k] });
+
+				odd[k] = { even[k].first - rotated.first, even[k].second - rotated.second };
+				even[k] = { even[k].first + rotated.first, even[k].second + rotated.second };
+			}
+		}
+	}
+
+	static ComplexT Multiply(const ComplexT& a, const ComplexT& b)
+	{
+		return { a.first * b.first - a.second * b.second, a.first * b.second + a.second * b.first };
+	}
+
+	//small DFT of radix items in place
+	void RadixKernel(unsigned int radix, ComplexT* a) const
+	{
+		//multiplying by i for inverse, by -i for forward
+		Real rotation = _direction == FftDirection::Forward ? Real(-1) : Real(1);
+
+		switch (radix)
+		{
+		case 2:
+		{
+			ComplexT a0 = a[0];
+			a[0] = { a0.first + a[1].first, a0.second + a[1].second };
+			a[1] = { a0.first - a[1].first, a0.second - a[1].second };
+			break;
+		}
+		case 3:
+		{
+			const Real sinThird = Real(0.866025403784438646764);
+
+			ComplexT sum{ a[1].first + a[2].first, a[1].second + a[2].second };
+			ComplexT diff{ rotation * sinThird * (a[1].first - a[2].first), rotation * sinThird * (a[1].second - a[2].second) };
+			ComplexT half{ a[0].first - Real(0.5) * sum.first, a[0].second - Real(0.5) * sum.second };
+
+			a[0] = { a[0].first + sum.first, a[0].second + sum.second };
+			//half +- i * diff
+			a[1] = { half.first - diff.second, half.second + diff.first };
+			a[2] = { half.first + diff.second, half.second - diff.first };
+			break;
+		}
+		case 4:
+		{
+			ComplexT sum02{ a[0].first + a[2].first, a[0].second + a[2].second };
+			ComplexT diff02{ a[0].first - a[2].first, a[0].second - a[2].second };
+			ComplexT sum13{ a[1].first + a[3].first, a[1].second + a[3].second };
+			//(a1 - a3) rotated by -i for forward, i for inverse
+			ComplexT diff13{ -rotation * (a[1].second - a[3].second), rotation * (a[1].first - a[3].first) };
+
+			a[0] = { sum02.first + sum13.first, sum02.second + sum13.second };
+			a[1] = { diff02.first + diff13.first, diff02.second + diff13.second };
+			a[2] = { sum02.first - sum13.first, sum02.second - sum13.second };
+			a[3] = { diff02.first - diff13.first, diff02.second - diff13.second };
+			break;
+		}
+		default:
+		{
+			//5 and 7 use direct DFT with cached roots
+			const std::vector<ComplexT>& roots = _radixRoots[radix];
+			ComplexT input[8];
+			std::copy(a, a + radix, input);
+
+			for (unsigned int t = 0; t < radix; ++t)
+			{
+				ComplexT sum = input[0];
+				for (unsigned int r = 1; r < radix; ++r)
+				{
+					ComplexT product = Multiply(input[r], roots[(r * t) % radix]);
+					sum.first += product.first;
+					sum.second += product.second;
+				}
+				a[t] = sum;
+			}
+			break;
+		}
+		}
+	}
+
+	//Stockham autosort, every stage reads from one buffer and writes to the other so no permutation is needed
+	//stage: y[k + s*(p*q + t)] = w^(q*t) * DFT_p(x[k + s*(q + r*m)])[t]
+	void RunStages(ComplexT* data, ComplexT* scratch) const
+	{
+		ComplexT* source = data;
+		ComplexT* target = scratch;
+
+		for (const Stage& stage : _stages)
+		{
+			const unsigned int radix = stage.radix;
+			const unsigned int stride = stage.stride;
+			const unsigned int count = stage.count;
+			const ComplexT* stageTwiddles = &_twiddles[stage.twiddleOffset];
+
+			ComplexT items[8];
+
+			for (unsigned int q = 0; q < count; ++q)
+			{
+				const ComplexT* twiddles = stageTwiddles + q * (radix - 1);
+
+				for (unsigned int k = 0; k < stride; ++k)
+				{
+					for (unsigned int r = 0; r < radix; ++r)
+					{
+						items[r] = source[k + stride * (q + r * count)];
+					}
+
+					RadixKernel(radix, items);
+
+					ComplexT* output = target + k + stride * radix * q;
+					output[0] = items[0];
+					for (unsigned int t = 1; t < radix; ++t)
+					{
+						output[stride * t] = Multiply(items[t], twiddles[t - 1]);
+					}
+				}
+			}
+
+			std::swap(source, target);
+		}
+
+		if (source != data)
+		{
+			std::copy(source, source + _size, data);
+		}
+	}
+
+	//X[k] = w[k] * sum(x[n] * w[n] * conj(w[k - n])), convolution is done with power of two FFTs
+	void RunBluestein(ComplexT* data, ComplexT* scratch) const
+	{
+		for (unsigned int n = 0; n < _size; ++n)
+		{
+			scratch[n] = Multiply(data[n], _chirp[n]);
+		}
+		std::fill(scratch + _size, scratch + _convolutionSize, ComplexT{ Real(0), Real(0) });
+
+		_forwardConvolution->ExecuteInPlace(scratch, nullptr);
+
+		for (unsigned int index = 0; index < _convolutionSize; ++index)
+		{
+			scratch[index] = Multiply(scratch[index], _chirpSpectrum[index]);
+		}
+
+		_inverseConvolution->ExecuteInPlace(scratch, nullptr);
+
+		for (unsigned int k = 0; k < _size; ++k)
+		{
+			data[k] = Multiply(scratch[k], _chirp[k]);
+		}
+	}
+
+	unsigned int _size{ 0 };
+	FftDirection _direction{ FftDirection::Forward };
+	FftAlgorithm _algorithm{ FftAlgorithm::Radix2 };
+
+	//radix-2 and mixed radix tables
+	std::vector<unsigned int> _permutation;
+	std::vector<ComplexT> _twiddles;
+	AlignedVector<Real> _splitTwiddleRe;
+	AlignedVector<Real> _splitTwiddleIm;
+	AlignedVector<Real> _splitCubeRe;
+	AlignedVector<Real> _splitCubeIm;
+	unsigned int _leafSize{ 1 };
+	FftCodelet<Real> _leafCodelet{ nullptr };
+	std::vector<unsigned int> _radices;
+	std::vector<Stage> _stages;
+	std::vector<ComplexT> _radixRoots[8];
+
+	//bluestein tables
+	unsigned int _convolutionSize{ 0 };
+	std::vector<ComplexT> _chirp;
+	std::vector<ComplexT> _chirpSpectrum;
+	FftPlanPtr<Real> _forwardConvolution;
+	FftPlanPtr<Real> _inverseConvolution;
+};
+
+using FftPlan = FftPlanT<float>;
+using FftPlanDouble = FftPlanT<double>;
+
+//returns shared read only plan, plans are created on first use and cached for lifetime of the program
+template<typename Real>
+FftPlanPtr<Real> GetFftPlan(unsigned int size, FftDirection direction)
+{
+	static std::mutex cacheMutex;
+	static std::map<std::pair<unsigned int, FftDirection>, FftPlanPtr<Real>> cache;
+
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+
+		auto found = cache.find({ size, direction });
+		if (found != cache.end())
+		{
+			return found->second;
+		}
+	}
+
+	//plan is built without lock held, bluestein plans request their own sub plans from the cache
+	FftPlanPtr<Real> plan = std::make_shared<const FftPlanT<Real>>(size, direction);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	//another thread might have built same plan meanwhile, first one wins
+	auto inserted = cache.insert({ { size, direction }, plan });
+	return inserted.first->second;
+}
@@ -0,0 +1,248 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include "WindowFunctions.h"
+
+//windowed sinc low pass with numTaps taps, cutoff is fraction of sampling rate (0..0.5), gain 1 at dc
+//odd numTaps gives symmetric filter with whole sample delay (numTaps - 1) / 2
+template<typename Real>
+std::vector<Real> DesignLowPass(unsigned int numTaps, double cutoff, WindowType window = WindowType::Kaiser, double windowParameter = -1.0)
+{
+	const double pi = 3.141592653589793238463;
+
+	WindowPtr<double> table = GetWindow<double>(window, numTaps, windowParameter, true);
+	double center = (numTaps - 1) / 2.0;
+
+	std::vector<double> taps(numTaps);
+	double sum = 0.0;
+	for (unsigned int index = 0; index < numTaps; ++index)
+	{
+		double x = index - center;
+		double sinc = x == 0.0 ? 2.0 * cutoff : sin(2.0 * pi * cutoff * x) / (pi * x);
+		taps[index] = sinc * (*table)[index];
+		sum += taps[index];
+	}
+
+	std::vector<Real> result(numTaps);
+	for (unsigned int index = 0; index < numTaps; ++index)
+	{
+		result[index] = static_cast<Real>(sum != 0.0 ? taps[index] / sum : taps[index]);
+	}
+	return result;
+}
+
+//high pass by spectral inversion of low pass, even numTaps is rounded up to next odd one,
+//inversion needs center tap so filter stays symmetric with whole sample delay
+template<typename Real>
+std::vector<Real> DesignHighPass(unsigned int numTaps, double cutoff, WindowType window = WindowType::Kaiser, double windowParameter = -1.0)
+{
+	numTaps |= 1;
+
+	std::vector<Real> taps = DesignLowPass<Real>(numTaps, cutoff, window, windowParameter);
+	for (auto& tap : taps)
+	{
+		tap = -tap;
+	}
+	taps[numTaps / 2] += Real(1);
+	return taps;
+}
+
+enum class FirMode
+{
+	Filter,			//one output per input sample
+	Decimate,		//one output per factor input samples, only kept outputs are computed
+	Interpolate		//factor outputs per input sample, zero stuffed samples are never multiplied
+};
+
+//time domain FIR y[n] = sum h[k] * x[n-k] over channels with independent state kept between blocks
+//every channel has delay line of numTaps - 1 history samples followed by new block in one aligned buffer,
+//taps are stored reversed so every output is dot product over contiguous memory:
+//filter and interpolate run vectorized across consecutive outputs, decimate runs vectorized dot per kept output
+//interpolation splits taps into factor polyphase branches of numTaps / factor taps scaled by factor so dc gain is kept
+//channels are spread across thread pool
+template<typename Real>
+class FirFilterT
+{
+public:
+	FirFilterT(const std::vector<Real>& taps, unsigned int numChannels = 1, FirMode mode = FirMode::Filter, unsigned int factor = 1) :
+		_numTaps(static_cast<unsigned int>(taps.size())),
+		_numChannels(numChannels),
+		_mode(mode),
+		_factor(mode == FirMode::Filter || factor == 0 ? 1 : factor)
+	{
+		BuildBranches(taps);
+
+		_buffers.resize(_numChannels);
+		for (auto& buffer : _buffers)
+		{
+			buffer.resize(_branchSize - 1 + chunkSize);
+		}
+		Reset();
+	}
+
+	unsigned int GetNumTaps() const
+	{
+		return _numTaps;
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	FirMode GetMode() const
+	{
+		return _mode;
+	}
+
+	unsigned int GetFactor() const
+	{
+		return _factor;
+	}
+
+	//outputs per channel next Process call of count samples writes
+	unsigned int GetOutputCount(unsigned int count) const
+	{
+		switch (_mode)
+		{
+		case FirMode::Decimate:
+			return _decimationOffset < count ? (count - 1 - _decimationOffset) / _factor + 1 : 0;
+		case FirMode::Interpolate:
+			return count * _factor;
+		default:
+			return count;
+		}
+	}
+
+	//count samples of every channel, output channels need GetOutputCount(count) items, returns outputs per channel
+	unsigned int Process(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		unsigned int written = 0;
+
+		for (unsigned int done = 0; done < count; )
+		{
+			unsigned int numSamples = count - done < chunkSize ? count - done : chunkSize;
+			unsigned int numOutputs = GetOutputCount(numSamples);
+
+			GetThreadPool().ParallelFor(_numChannels, [&](unsigned int channelBegin, unsigned int channelEnd)
+			{
+				for (unsigned int channel = channelBegin; channel < channelEnd; ++channel)
+				{
+					RunChunk(channel, input[channel] + done, numSamples, output[channel] + written);
+				}
+			});
+
+			if (_mode == FirMode::Decimate)
+			{
+				_decimationOffset = _decimationOffset + numOutputs * _factor - numSamples;
+			}
+
+			written += numOutputs;
+			done += numSamples;
+		}
+
+		return written;
+	}
+
+	//single channel filter
+	unsigned int Process(const Real* input, unsigned int count, Real* output)
+	{
+		return Process(&input, count, &output);
+	}
+
+	void Reset()
+	{
+		for (auto& buffer : _buffers)
+		{
+			std::fill(buffer.begin(), buffer.end(), Real(0));
+		}
+		_decimationOffset = 0;
+	}
+
+private:
+	static const unsigned int chunkSize = 4096;
+
+	void BuildBranches(const std::vector<Real>& taps)
+	{
+		unsigned int numBranches = _mode == FirMode::Interpolate ? _factor : 1;
+		Real gain = static_cast<Real>(numBranches);
+
+		_branchSize = (_numTaps + numBranches - 1) / numBranches;
+		if (_branchSize == 0)
+		{
+			_branchSize = 1;
+		}
+
+		//branch p holds taps p, p + L, p + 2L ... reversed
+		_branches.resize(numBranches);
+		for (unsigned int branch = 0; branch < numBranches; ++branch)
+		{
+			_branches[branch].assign(_branchSize, Real(0));
+			for (unsigned int index = 0; index < _branchSize; ++index)
+			{
+				unsigned int tap = index * numBranches + branch;
+				if (tap < _numTaps)
+				{
+					_branches[branch][_branchSize - 1 - index] = taps[tap] * gain;
+				}
+			}
+		}
+	}
+
+	void RunChunk(unsigned int channel, const Real* input, unsigned int count, Real* output)
+	{
+		AlignedVector<Real>& buffer = _buffers[channel];
+		unsigned int history = _branchSize - 1;
+
+		std::copy(input, input + count, buffer.begin() + history);
+
+		switch (_mode)
+		{
+		case FirMode::Filter:
+			FirBlock(buffer.data(), _branches[0].data(), _branchSize, output, count);
+			break;
+		case FirMode::Decimate:
+		{
+			unsigned int numOutputs = GetOutputCount(count);
+			for (unsigned int index = 0; index < numOutputs; ++index)
+			{
+				output[index] = Dot(_branches[0].data(), buffer.data() + _decimationOffset + index * _factor, _branchSize);
+			}
+			break;
+		}
+		case FirMode::Interpolate:
+		{
+			thread_local AlignedVector<Real> branchOutput;
+			branchOutput.resize(chunkSize);
+
+			for (unsigned int branch = 0; branch < _factor; ++branch)
+			{
+				FirBlock(buffer.data(), _branches[branch].data(), _branchSize, branchOutput.data(), count);
+				for (unsigned int index = 0; index < count; ++index)
+				{
+					output[index * _factor + branch] = branchOutput[index];
+				}
+			}
+			break;
+		}
+		}
+
+		//last samples become history of next chunk
+		std::copy(buffer.begin() + count, buffer.begin() + count + history, buffer.begin());
+	}
+
+	unsigned int _numTaps{ 0 };
+	unsigned int _numChannels{ 0 };
+	FirMode _mode{ FirMode::Filter };
+	unsigned int _factor{ 1 };
+	unsigned int _branchSize{ 0 };
+	std::vector<AlignedVector<Real>> _branches;
+	std::vector<AlignedVector<Real>> _buffers;
+	unsigned int _decimationOffset{ 0 };
+};
+
+using FirFilter = FirFilterT<float>;
\ No newline at end of file
@@ -0,0 +1,411 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <algorithm>
+#include <math.h>
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include "WindowFunctions.h"
+
+template<typename Real>
+using FarrowTablePtr = std::shared_ptr<const AlignedVector<Real>>;
+
+//kaiser windowed sinc interpolation kernel of numTaps taps, zero at |time| >= numTaps / 2
+//16 taps keep error of interpolated tone near 1e-4 of its amplitude up to 0.3 of sampling rate
+inline double GetFarrowKernelValue(double time, unsigned int numTaps)
+{
+	const double pi = 3.141592653589793238463;
+	const double beta = 8.0;
+
+	double half = numTaps / 2.0;
+	if (fabs(time) >= half)
+	{
+		return 0.0;
+	}
+
+	double ratio = time / half;
+	double window = BesselI0(beta * sqrt(1.0 - ratio * ratio)) / BesselI0(beta);
+	double sinc = time == 0.0 ? 1.0 : sin(pi * time) / (pi * time);
+	return sinc * window;
+}
+
+//returns shared read only farrow table for numTaps taps and polynomials of degree, built on first use and cached
+//row k holds coefficient of mu^k for every tap, weight of tap j at fraction mu is sum table[k * numTaps + j] * mu^k
+//and approximates kernel at mu + numTaps / 2 - 1 - j, polynomial of every tap goes through kernel at
+//chebyshev-lobatto nodes of [0, 1] so fractions 0 and 1 give whole samples exactly
+template<typename Real>
+FarrowTablePtr<Real> GetFarrowTable(unsigned int numTaps, unsigned int degree)
+{
+	const double pi = 3.141592653589793238463;
+	static std::mutex cacheMutex;
+	static std::map<std::pair<unsigned int, unsigned int>, FarrowTablePtr<Real>> cache;
+
+	std::pair<unsigned int, unsigned int> key{ numTaps, degree };
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto found = cache.find(key);
+	if (found != cache.end())
+	{
+		return found->second;
+	}
+
+	unsigned int numNodes = degree + 1;
+	std::vector<double> nodes(numNodes);
+	for (unsigned int node = 0; node < numNodes; ++node)
+	{
+		nodes[node] = degree != 0 ? (1.0 - cos(pi * node / degree)) / 2.0 : 0.0;
+	}
+
+	std::shared_ptr<AlignedVector<Real>> table = std::make_shared<AlignedVector<Real>>(static_cast<size_t>(numNodes) * numTaps, Real(0));
+	std::vector<double> system(static_cast<size_t>(numNodes) * (numNodes + 1));
+	for (unsigned int tap = 0; tap < numTaps; ++tap)
+	{
+		//vandermonde system of nodes with kernel values as last column
+		for (unsigned int row = 0; row < numNodes; ++row)
+		{
+			double power = 1.0;
+			for (unsigned int column = 0; column < numNodes; ++column)
+			{
+				system[row * (numNodes + 1) + column] = power;
+				power *= nodes[row];
+			}
+			system[row * (numNodes + 1) + numNodes] = GetFarrowKernelValue(nodes[row] + numTaps / 2.0 - 1.0 - tap, numTaps);
+		}
+
+		//gauss elimination with partial pivoting
+		for (unsigned int column = 0; column < numNodes; ++column)
+		{
+			unsigned int pivot = column;
+			for (unsigned int row = column + 1; row < numNodes; ++row)
+			{
+				if (fabs(system[row * (numNodes + 1) + column]) > fabs(system[pivot * (numNodes + 1) + column]))
+				{
+					pivot = row;
+				}
+			}
+			for (unsigned int item = 0; item <= numNodes; ++item)
+			{
+				std::swap(system[column * (numNodes + 1) + item], system[pivot * (numNodes + 1) + item]);
+			}
+
+			for (unsigned int row = 0; row < numNodes; ++row)
+			{
+				if (row == column)
+				{
+					continue;
+				}
+				double factor = system[row * (numNodes + 1) + column] / system[column * (numNodes + 1) + column];
+				for (unsigned int item = column; item <= numNodes; ++item)
+				{
+					system[row * (numNodes + 1) + item] -= factor * system[column * (numNodes + 1) + item];
+				}
+			}
+		}
+
+		for (unsigned int power = 0; power < numNodes; ++power)
+		{
+			double coefficient = system[power * (numNodes + 1) + numNodes] / system[power * (numNodes + 1) + power];
+			(*table)[static_cast<size_t>(power) * numTaps + tap] = static_cast<Real>(coefficient);
+		}
+	}
+
+	cache.insert({ key, table });
+	return table;
+}
+
+//tap weights at fraction mu, weights[j] multiplies sample j of window
+template<typename Real>
+void GetFarrowWeights(const Real* table, unsigned int numTaps, unsigned int degree, double mu, Real* weights)
+{
+	for (unsigned int tap = 0; tap < numTaps; ++tap)
+	{
+		double weight = table[static_cast<size_t>(degree) * numTaps + tap];
+		for (unsigned int power = degree; power-- > 0; )
+		{
+			weight = weight * mu + table[static_cast<size_t>(power) * numTaps + tap];
+		}
+		weights[tap] = static_cast<Real>(weight);
+	}
+}
+
+//tap count is rounded up to multiple of 4 so weights fill whole SIMD vectors, at least 4
+inline unsigned int GetFarrowTapCount(unsigned int numTaps)
+{
+	return numTaps < 4 ? 4 : (numTaps + 3) / 4 * 4;
+}
+
+//arbitrary ratio resampling with farrow structure, channels with shared state kept between blocks
+//output m lies at input time m * step where step = 1 / ratio, its window of numTaps samples around that time
+//is weighted by polynomials in fractional part of time evaluated from fixed table, so ratio can change
+//at every block (clock drift tracking) without touching any table
+//kernel is full band windowed sinc, ratio well below 1 aliases and should go through polyphase Resample first,
+//farrow then only corrects small remaining drift
+//output comes out once input runs numTaps / 2 samples past its time, outputs are spread across thread pool
+template<typename Real>
+class FarrowResamplerT
+{
+public:
+	//ratio is output rate / input rate
+	FarrowResamplerT(double ratio = 1.0, unsigned int numChannels = 1, unsigned int numTaps = 16, unsigned int degree = 5) :
+		_numChannels(numChannels),
+		_numTaps(GetFarrowTapCount(numTaps)),
+		_degree(degree)
+	{
+		_table = GetFarrowTable<Real>(_numTaps, _degree);
+		SetRatio(ratio);
+
+		_buffers.resize(_numChannels);
+		for (auto& buffer : _buffers)
+		{
+			buffer.resize(_numTaps - 1 + chunkSize);
+		}
+		Reset();
+	}
+
+	//takes effect from next output
+	void SetRatio(double ratio)
+	{
+		_ratio = ratio > 0.0 ? ratio : 1.0;
+		_step = 1.0 / _ratio;
+	}
+
+	double GetRatio() const
+	{
+		return _ratio;
+	}
+
+	unsigned int GetNumTaps() const
+	{
+		return _numTaps;
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	//input samples output lags behind
+	unsigned int GetLatency() const
+	{
+		return _numTaps / 2;
+	}
+
+	//outputs per channel next Process call of count samples writes with current ratio
+	unsigned int GetOutputCount(unsigned int count) const
+	{
+		return CountOutputs(count);
+	}
+
+	//count samples of every channel, output channels need GetOutputCount(count) items, returns outputs per channel
+	unsigned int Process(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		unsigned int written = 0;
+		unsigned int history = _numTaps - 1;
+
+		for (unsigned int done = 0; done < count; )
+		{
+			unsigned int numSamples = count - done < chunkSize ? count - done : chunkSize;
+			unsigned int numOutputs = CountOutputs(numSamples);
+
+			for (unsigned int channel = 0; channel < _numChannels; ++channel)
+			{
+				std::copy(input[channel] + done, input[channel] + done + numSamples, _buffers[channel].begin() + history);
+			}
+
+			//window of time t starts at chunk sample floor(t) - numTaps / 2 + 1, which is buffer item floor(t) + numTaps / 2
+			GetThreadPool().ParallelFor(numOutputs, [&](unsigned int outputBegin, unsigned int outputEnd)
+			{
+				for (unsigned int channel = 0; channel < _numChannels; ++channel)
+				{
+					FarrowBlock(_buffers[channel].data() + _numTaps / 2, _table->data(), _numTaps, _degree,
+						_time, _step, outputBegin, outputEnd - outputBegin, output[channel] + written + outputBegin);
+				}
+			}, 256);
+
+			_time += numOutputs * _step - numSamples;
+
+			//last samples become history of next chunk
+			for (auto& buffer : _buffers)
+			{
+				std::copy(buffer.begin() + numSamples, buffer.begin() + numSamples + history, buffer.begin());
+			}
+
+			written += numOutputs;
+			done += numSamples;
+		}
+
+		return written;
+	}
+
+	//single channel conversion
+	unsigned int Process(const Real* input, unsigned int count, Real* output)
+	{
+		return Process(&input, count, &output);
+	}
+
+	void Reset()
+	{
+		for (auto& buffer : _buffers)
+		{
+			std::fill(buffer.begin(), buffer.end(), Real(0));
+		}
+		_time = 0.0;
+	}
+
+private:
+	static const unsigned int chunkSize = 4096;
+
+	//outputs whose newest window sample floor(t) + numTaps / 2 is inside chunk, times are computed
+	//exactly like kernel computes them so count and windows always agree
+	unsigned int CountOutputs(unsigned int count) const
+	{
+		double limit = static_cast<double>(count) - _numTaps / 2;
+		if (_time >= limit)
+		{
+			return 0;
+		}
+
+		unsigned int numOutputs = static_cast<unsigned int>(ceil((limit - _time) / _step));
+		while (numOutputs > 0 && floor(_time + static_cast<double>(numOutputs - 1) * _step) >= limit)
+		{
+			--numOutputs;
+		}
+		while (floor(_time + static_cast<double>(numOutputs) * _step) < limit)
+		{
+			++numOutputs;
+		}
+		return numOutputs;
+	}
+
+	unsigned int _numChannels{ 0 };
+	unsigned int _numTaps{ 0 };
+	unsigned int _degree{ 0 };
+	FarrowTablePtr<Real> _table;
+	double _ratio{ 1.0 };
+	double _step{ 1.0 };
+	std::vector<AlignedVector<Real>> _buffers;
+
+	//time of next output in input samples from first sample of next block
+	double _time{ 0.0 };
+};
+
+using FarrowResampler = FarrowResamplerT<float>;
+
+//fractional delay y[n] = x(n - GetLatency() - delay) with own delay per channel, sub-sample alignment of channels
+//delay of channel can change at every block, its taps are evaluated from fixed farrow table and
+//channel is then plain FIR run vectorized across outputs, whole part of delay only moves window back in history
+template<typename Real>
+class FractionalDelayT
+{
+public:
+	//delays are in samples between 0 and maxDelay
+	FractionalDelayT(unsigned int numChannels = 1, double maxDelay = 16.0, unsigned int numTaps = 16, unsigned int degree = 5) :
+		_numChannels(numChannels),
+		_numTaps(GetFarrowTapCount(numTaps)),
+		_degree(degree)
+	{
+		_table = GetFarrowTable<Real>(_numTaps, _degree);
+		_history = _numTaps + static_cast<unsigned int>(maxDelay > 0.0 ? ceil(maxDelay) : 0.0);
+		_maxDelay = maxDelay > 0.0 ? maxDelay : 0.0;
+
+		_delays.assign(_numChannels, 0.0);
+		_weights.resize(_numChannels);
+		_offsets.assign(_numChannels, 0);
+		_buffers.resize(_numChannels);
+		for (unsigned int channel = 0; channel < _numChannels; ++channel)
+		{
+			_weights[channel].resize(_numTaps);
+			_buffers[channel].resize(_history + chunkSize);
+			SetDelay(channel, 0.0);
+		}
+		Reset();
+	}
+
+	//takes effect from next block
+	void SetDelay(unsigned int channel, double delay)
+	{
+		delay = (std::max)(0.0, (std::min)(delay, _maxDelay));
+		_delays[channel] = delay;
+
+		//time n - numTaps / 2 - delay is whole sample n - numTaps / 2 - whole - 1 plus fraction 1 - (delay - whole)
+		double whole = floor(delay);
+		GetFarrowWeights(_table->data(), _numTaps, _degree, 1.0 - (delay - whole), _weights[channel].data());
+		_offsets[channel] = static_cast<unsigned int>(whole);
+	}
+
+	double GetDelay(unsigned int channel) const
+	{
+		return _delays[channel];
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	//samples every channel lags behind on top of its own delay
+	unsigned int GetLatency() const
+	{
+		return _numTaps / 2;
+	}
+
+	//count samples in and count samples out per channel
+	void Process(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		for (unsigned int done = 0; done < count; )
+		{
+			unsigned int numSamples = count - done < chunkSize ? count - done : chunkSize;
+
+			GetThreadPool().ParallelFor(_numChannels, [&](unsigned int channelBegin, unsigned int channelEnd)
+			{
+				for (unsigned int channel = channelBegin; channel < channelEnd; ++channel)
+				{
+					AlignedVector<Real>& buffer = _buffers[channel];
+					std::copy(input[channel] + done, input[channel] + done + numSamples, buffer.begin() + _history);
+
+					//window of output n starts at sample n - numTaps - whole
+					const Real* window = buffer.data() + _history - _numTaps - _offsets[channel];
+					FirBlock(window, _weights[channel].data(), _numTaps, output[channel] + done, numSamples);
+
+					std::copy(buffer.begin() + numSamples, buffer.begin() + numSamples + _history, buffer.begin());
+				}
+			});
+
+			done += numSamples;
+		}
+	}
+
+	//single channel delay
+	void Process(const Real* input, unsigned int count, Real* output)
+	{
+		Process(&input, count, &output);
+	}
+
+	void Reset()
+	{
+		for (auto& buffer : _buffers)
+		{
+			std::fill(buffer.begin(), buffer.end(), Real(0));
+		}
+	}
+
+private:
+	static const unsigned int chunkSize = 4096;
+
+	unsigned int _numChannels{ 0 };
+	unsigned int _numTaps{ 0 };
+	unsigned int _degree{ 0 };
+	unsigned int _history{ 0 };
+	double _maxDelay{ 0.0 };
+	FarrowTablePtr<Real> _table;
+	std::vector<double> _delays;
+	std::vector<AlignedVector<Real>> _weights;
+	std::vector<unsigned int> _offsets;
+	std::vector<AlignedVector<Real>> _buffers;
+};
+
+using FractionalDelay = FractionalDelayT<float>;
\ No newline at end of file
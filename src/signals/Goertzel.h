@@ -0,0 +1,153 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <math.h>
+#include "ThreadPool.h"
+
+//evaluates DFT only at chosen bins in O(N) per bin instead of full O(N log N) spectrum
+//bins may be fractional (bin = frequency * N / samplingRate), generalized Goertzel:
+//s[n] = x[n] + 2cos(w) * s[n-1] - s[n-2], X(w) = (s[N-1] - exp(-iw) * s[N-2]) * exp(-iw(N-1))
+//result matches unscaled forward FFT bin, recurrence runs in double so long signals keep precision
+//all bins of one sample are updated together so inner loop vectorizes over bins, channels are spread across thread pool
+template<typename Real>
+class GoertzelBankT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	GoertzelBankT(unsigned int size, const std::vector<double>& bins) :
+		_size(size),
+		_numBins(static_cast<unsigned int>(bins.size()))
+	{
+		const double twoPi = 6.283185307179586476925;
+
+		_coefficients.resize(_numBins);
+		_cosines.resize(_numBins);
+		_sines.resize(_numBins);
+		_phases.resize(_numBins);
+
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			double omega = size != 0 ? twoPi * bins[bin] / size : 0.0;
+			_cosines[bin] = cos(omega);
+			_sines[bin] = sin(omega);
+			_coefficients[bin] = 2.0 * _cosines[bin];
+
+			double phase = size != 0 ? -omega * (size - 1) : 0.0;
+			_phases[bin] = { cos(phase), sin(phase) };
+		}
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	unsigned int GetNumBins() const
+	{
+		return _numBins;
+	}
+
+	//input has GetSize() complex samples, output receives GetNumBins() bins
+	void Execute(const ComplexT* input, ComplexT* output) const
+	{
+		State real(_numBins);
+		State imaginary(_numBins);
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			Step(real, input[index].first);
+			Step(imaginary, input[index].second);
+		}
+
+		//goertzel is linear so X = G(real part) + i * G(imaginary part)
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			std::pair<double, double> realPart = Finish(real, bin);
+			std::pair<double, double> imaginaryPart = Finish(imaginary, bin);
+			output[bin] = { static_cast<Real>(realPart.first - imaginaryPart.second), static_cast<Real>(realPart.second + imaginaryPart.first) };
+		}
+	}
+
+	//real input, half the work of complex one
+	void Execute(const Real* input, ComplexT* output) const
+	{
+		State real(_numBins);
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			Step(real, input[index]);
+		}
+
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			std::pair<double, double> result = Finish(real, bin);
+			output[bin] = { static_cast<Real>(result.first), static_cast<Real>(result.second) };
+		}
+	}
+
+	//channels[c] points to GetSize() samples of channel c, bins of channel c go to output[c * GetNumBins() + bin]
+	template<typename Sample>
+	void Execute(const Sample* const* channels, unsigned int numChannels, ComplexT* output) const
+	{
+		GetThreadPool().ParallelFor(numChannels, [&](unsigned int channelBegin, unsigned int channelEnd)
+		{
+			for (unsigned int channel = channelBegin; channel < channelEnd; ++channel)
+			{
+				Execute(channels[channel], output + static_cast<size_t>(channel) * _numBins);
+			}
+		});
+	}
+
+private:
+	struct State
+	{
+		State(unsigned int numBins) :
+			previous(numBins, 0.0),
+			beforePrevious(numBins, 0.0)
+		{
+		}
+
+		std::vector<double> previous;
+		std::vector<double> beforePrevious;
+	};
+
+	void Step(State& state, double sample) const
+	{
+		double* previous = state.previous.data();
+		double* beforePrevious = state.beforePrevious.data();
+		const double* coefficients = _coefficients.data();
+
+		for (unsigned int bin = 0; bin < _numBins; ++bin)
+		{
+			double current = sample + coefficients[bin] * previous[bin] - beforePrevious[bin];
+			beforePrevious[bin] = previous[bin];
+			previous[bin] = current;
+		}
+	}
+
+	std::pair<double, double> Finish(const State& state, unsigned int bin) const
+	{
+		//s[N-1] - exp(-iw) * s[N-2]
+		double real = state.previous[bin] - _cosines[bin] * state.beforePrevious[bin];
+		double imaginary = _sines[bin] * state.beforePrevious[bin];
+
+		const std::pair<double, double>& phase = _phases[bin];
+		return { real * phase.first - imaginary * phase.second, real * phase.second + imaginary * phase.first };
+	}
+
+	unsigned int _size{ 0 };
+	unsigned int _numBins{ 0 };
+	std::vector<double> _coefficients;
+	std::vector<double> _cosines;
+	std::vector<double> _sines;
+	std::vector<std::pair<double, double>> _phases;
+};
+
+using GoertzelBank = GoertzelBankT<float>;
+
+//fractional bin of frequency in Hz for signal of size samples
+inline double GetBinForFrequency(float frequency, unsigned int size, unsigned int samplingRate)
+{
+	return static_cast<double>(frequency) * size / samplingRate;
+}
\ No newline at end of file
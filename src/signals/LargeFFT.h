@@ -0,0 +1,276 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <atomic>
+#include <algorithm>
+#include <math.h>
+#include "FFTPlan.h"
+#include "ThreadPool.h"
+
+//sizes from this one up go through four step FFT in FastFT, can be changed with SetLargeFftThreshold
+inline std::atomic<unsigned int>& LargeFftThreshold()
+{
+	static std::atomic<unsigned int> threshold{ 1u << 20 };
+	return threshold;
+}
+
+inline void SetLargeFftThreshold(unsigned int size)
+{
+	LargeFftThreshold() = size;
+}
+
+//four step FFT for transforms much bigger than cache
+//N = N1 * N2 is viewed as N1 x N2 row major matrix:
+//1. FFT of size N1 over every column, columns are gathered in tiles so reads stay sequential, then twiddle W_N^(n2*k1)
+//2. FFT of size N2 over every row
+//3. blocked transpose N1 x N2 -> N2 x N1 gives natural order output
+//columns, rows and transpose tiles are independent and spread across thread pool
+template<typename Real>
+class FourStepFftT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	FourStepFftT(unsigned int size, FftDirection direction, ThreadPool& pool = GetThreadPool()) :
+		_size(size),
+		_direction(direction),
+		_pool(pool)
+	{
+		_rows = ChooseRows(size);
+		_columns = _rows != 0 ? size / _rows : 0;
+
+		if (_rows != 0)
+		{
+			_columnPlan = GetFftPlan<Real>(_rows, direction);
+			_rowPlan = GetFftPlan<Real>(_columns, direction);
+			BuildTwiddles();
+		}
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	FftDirection GetDirection() const
+	{
+		return _direction;
+	}
+
+	//size needs to split into two factors of at least minFactor
+	static bool IsSupportedSize(unsigned int size)
+	{
+		return ChooseRows(size) != 0;
+	}
+
+	//out of place transform, input and output must not overlap, input is overwritten
+	void Execute(ComplexT* data, ComplexT* output) const
+	{
+		ColumnPass(data);
+		RowPass(data);
+		Transpose(data, output);
+	}
+
+	//in place transform, scratch has GetSize() items
+	void ExecuteInPlace(ComplexT* data, ComplexT* scratch) const
+	{
+		Execute(data, scratch);
+
+		_pool.ParallelFor(_size, [&](unsigned int begin, unsigned int end)
+		{
+			std::copy(scratch + begin, scratch + end, data + begin);
+		}, 1u << 16);
+	}
+
+	//in place transform with per thread scratch buffer, it only grows so repeated calls do not allocate
+	void Execute(std::vector<ComplexT>& data) const
+	{
+		thread_local std::vector<ComplexT> scratch;
+		if (scratch.size() < _size)
+		{
+			scratch.resize(_size);
+		}
+
+		ExecuteInPlace(data.data(), scratch.data());
+	}
+
+private:
+	static const unsigned int minFactor = 16;
+	static const unsigned int columnTile = 16;
+	static const unsigned int transposeTile = 32;
+
+	//largest divisor not above square root, rows and columns end up close to sqrt(N)
+	static unsigned int ChooseRows(unsigned int size)
+	{
+		unsigned int root = static_cast<unsigned int>(sqrt(static_cast<double>(size)));
+		for (unsigned int rows = root; rows >= minFactor; --rows)
+		{
+			if (size % rows == 0)
+			{
+				return rows;
+			}
+		}
+		return 0;
+	}
+
+	static ComplexT Multiply(const ComplexT& a, const ComplexT& b)
+	{
+		return { a.first * b.first - a.second * b.second, a.first * b.second + a.second * b.first };
+	}
+
+	void BuildTwiddles()
+	{
+		//W_N^m = coarse[m / rows] * fine[m % rows], keeps tables at O(sqrt(N)) instead of O(N)
+		const double twoPi = 6.283185307179586476925;
+		double sign = _direction == FftDirection::Forward ? -1.0 : 1.0;
+
+		_fineTwiddles.resize(_rows);
+		for (unsigned int index = 0; index < _rows; ++index)
+		{
+			double angle = sign * twoPi * index / _size;
+			_fineTwiddles[index] = { static_cast<Real>(cos(angle)), static_cast<Real>(sin(angle)) };
+		}
+
+		_coarseTwiddles.resize(_columns);
+		for (unsigned int index = 0; index < _columns; ++index)
+		{
+			double angle = sign * twoPi * (static_cast<double>(index) * _rows) / _size;
+			_coarseTwiddles[index] = { static_cast<Real>(cos(angle)), static_cast<Real>(sin(angle)) };
+		}
+	}
+
+	ComplexT GetTwiddle(unsigned long long exponent) const
+	{
+		unsigned int reduced = static_cast<unsigned int>(exponent % _size);
+		return Multiply(_coarseTwiddles[reduced / _rows], _fineTwiddles[reduced % _rows]);
+	}
+
+	void ColumnPass(ComplexT* data) const
+	{
+		unsigned int numTiles = (_columns + columnTile - 1) / columnTile;
+
+		_pool.ParallelFor(numTiles, [&](unsigned int tileBegin, unsigned int tileEnd)
+		{
+			thread_local std::vector<ComplexT> tile;
+			tile.resize(static_cast<size_t>(columnTile) * _rows);
+
+			for (unsigned int tileIndex = tileBegin; tileIndex < tileEnd; ++tileIndex)
+			{
+				unsigned int firstColumn = tileIndex * columnTile;
+				unsigned int width = _columns - firstColumn < columnTile ? _columns - firstColumn : columnTile;
+
+				//gather, each row read is width contiguous items
+				for (unsigned int row = 0; row < _rows; ++row)
+				{
+					const ComplexT* source = data + static_cast<size_t>(row) * _columns + firstColumn;
+					for (unsigned int column = 0; column < width; ++column)
+					{
+						tile[static_cast<size_t>(column) * _rows + row] = source[column];
+					}
+				}
+
+				for (unsigned int column = 0; column < width; ++column)
+				{
+					ComplexT* line = &tile[static_cast<size_t>(column) * _rows];
+					_columnPlan->Execute(line);
+
+					unsigned long long n2 = firstColumn + column;
+					for (unsigned int k1 = 1; k1 < _rows; ++k1)
+					{
+						line[k1] = Multiply(line[k1], GetTwiddle(n2 * k1));
+					}
+				}
+
+				//scatter back to same places
+				for (unsigned int row = 0; row < _rows; ++row)
+				{
+					ComplexT* target = data + static_cast<size_t>(row) * _columns + firstColumn;
+					for (unsigned int column = 0; column < width; ++column)
+					{
+						target[column] = tile[static_cast<size_t>(column) * _rows + row];
+					}
+				}
+			}
+		});
+	}
+
+	void RowPass(ComplexT* data) const
+	{
+		_pool.ParallelFor(_rows, [&](unsigned int rowBegin, unsigned int rowEnd)
+		{
+			for (unsigned int row = rowBegin; row < rowEnd; ++row)
+			{
+				_rowPlan->Execute(data + static_cast<size_t>(row) * _columns);
+			}
+		});
+	}
+
+	//output[k2 * rows + k1] = data[k1 * columns + k2], done in square tiles so both sides stay in cache
+	void Transpose(const ComplexT* data, ComplexT* output) const
+	{
+		unsigned int numRowTiles = (_rows + transposeTile - 1) / transposeTile;
+
+		_pool.ParallelFor(numRowTiles, [&](unsigned int tileBegin, unsigned int tileEnd)
+		{
+			for (unsigned int rowTile = tileBegin; rowTile < tileEnd; ++rowTile)
+			{
+				unsigned int rowStart = rowTile * transposeTile;
+				unsigned int rowEnd = (std::min)(rowStart + transposeTile, _rows);
+
+				for (unsigned int columnStart = 0; columnStart < _columns; columnStart += transposeTile)
+				{
+					unsigned int columnEnd = (std::min)(columnStart + transposeTile, _columns);
+
+					for (unsigned int row = rowStart; row < rowEnd; ++row)
+					{
+						for (unsigned int column = columnStart; column < columnEnd; ++column)
+						{
+							output[static_cast<size_t>(column) * _rows + row] = data[static_cast<size_t>(row) * _columns + column];
+						}
+					}
+				}
+			}
+		});
+	}
+
+	unsigned int _size{ 0 };
+	unsigned int _rows{ 0 };
+	unsigned int _columns{ 0 };
+	FftDirection _direction{ FftDirection::Forward };
+	ThreadPool& _pool;
+	FftPlanPtr<Real> _columnPlan;
+	FftPlanPtr<Real> _rowPlan;
+	std::vector<ComplexT> _fineTwiddles;
+	std::vector<ComplexT> _coarseTwiddles;
+};
+
+using FourStepFft = FourStepFftT<float>;
+
+template<typename Real>
+using FourStepFftPtr = std::shared_ptr<const FourStepFftT<Real>>;
+
+//shared read only four step plan, cached same way as GetFftPlan
+template<typename Real = float>
+FourStepFftPtr<Real> GetFourStepFft(unsigned int size, FftDirection direction = FftDirection::Forward)
+{
+	static std::mutex cacheMutex;
+	static std::map<std::pair<unsigned int, FftDirection>, FourStepFftPtr<Real>> cache;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto& plan = cache[{ size, direction }];
+	if (!plan)
+	{
+		plan = std::make_shared<const FourStepFftT<Real>>(size, direction);
+	}
+
+	return plan;
+}
+
+//true when transform of this size should take four step path
+inline bool UseLargeFft(unsigned int size)
+{
+	return size >= LargeFftThreshold() && FourStepFftT<float>::IsSupportedSize(size);
+}
@@ -0,0 +1,343 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "FFTPlan.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+//low latency streaming convolution y[n] = sum h[k] * x[n-k] for long kernels, partitioned overlap-save:
+//kernel is cut into partitions of B taps, every partition spectrum (FFT size 2B) is computed once,
+//every block of B input samples is transformed once and pushed into frequency domain delay line,
+//output block is inverse transform of sum over partitions of delayed input spectrum times partition spectrum
+//latency is B samples whatever the kernel length, FFT cost per sample depends only on B,
+//kernel length only adds complex multiply-adds which run vectorized and split across thread pool
+//non-uniform layout: first stage uses B, later stages use blocks growing by 4 up to maxBlockSize,
+//most of kernel is then covered by few large partitions and multiply-add count per sample drops by same ratio
+//stage with block S starts at kernel offset of at least 2 (S - B), so its output is due S - B samples after its
+//input block completes, its work is spread over the S / B blocks of B in between: forward transform in first step,
+//bins of multiply-adds in equal slices, inverse transform in last one, every block of B then costs about the same
+//and none of them waits for whole large stage, steps of stages running at same time run in parallel
+template<typename Real>
+class PartitionedConvolverT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//blockSize and maxBlockSize are rounded up to powers of two, maxBlockSize 0 or blockSize gives uniform partitions
+	PartitionedConvolverT(const ComplexT* kernel, unsigned int kernelSize, unsigned int blockSize = 64, unsigned int maxBlockSize = 0) :
+		_kernelSize(kernelSize)
+	{
+		_blockSize = RoundUp(blockSize);
+		unsigned int largestBlock = (std::max)(RoundUp(maxBlockSize), _blockSize);
+
+		BuildStages(kernel, largestBlock);
+
+		unsigned int span = 0;
+		for (const auto& stage : _stages)
+		{
+			span = (std::max)(span, stage->offset + stage->blockSize);
+		}
+		_outputRing.resize(RoundUp(2 * span + _blockSize));
+		Reset();
+	}
+
+	PartitionedConvolverT(const PartitionedConvolverT&) = delete;
+	PartitionedConvolverT& operator=(const PartitionedConvolverT&) = delete;
+
+	unsigned int GetKernelSize() const
+	{
+		return _kernelSize;
+	}
+
+	//input samples per block of first stage
+	unsigned int GetBlockSize() const
+	{
+		return _blockSize;
+	}
+
+	//output sample n is y[n - GetLatency()]
+	unsigned int GetLatency() const
+	{
+		return _blockSize;
+	}
+
+	unsigned int GetNumStages() const
+	{
+		return static_cast<unsigned int>(_stages.size());
+	}
+
+	//total partitions over all stages, multiply-adds per block of stage are partitions * 2 * block size
+	unsigned int GetNumPartitions() const
+	{
+		unsigned int numPartitions = 0;
+		for (const auto& stage : _stages)
+		{
+			numPartitions += stage->numPartitions;
+		}
+		return numPartitions;
+	}
+
+	//count samples in and count samples out, blocks of any length, output may equal input
+	void Process(const ComplexT* input, unsigned int count, ComplexT* output)
+	{
+		unsigned int mask = static_cast<unsigned int>(_outputRing.size()) - 1;
+
+		for (unsigned int done = 0; done < count; )
+		{
+			//chunks never cross block boundary of first stage, larger blocks are its multiples
+			unsigned int pending = _stages.empty() ? 0 : _stages[0]->numPending;
+			unsigned int numSamples = (std::min)(count - done, _blockSize - pending);
+
+			for (auto& stage : _stages)
+			{
+				std::copy(input + done, input + done + numSamples, stage->input.begin() + stage->blockSize + stage->numPending);
+				stage->numPending += numSamples;
+			}
+
+			for (unsigned int index = 0; index < numSamples; ++index)
+			{
+				unsigned long long position = _position + index;
+				if (position >= _blockSize)
+				{
+					ComplexT& value = _outputRing[(position - _blockSize) & mask];
+					output[done + index] = value;
+					value = ComplexT{ Real(0), Real(0) };
+				}
+				else
+				{
+					output[done + index] = ComplexT{ Real(0), Real(0) };
+				}
+			}
+
+			_position += numSamples;
+			done += numSamples;
+
+			RunDueStages();
+		}
+	}
+
+	void Reset()
+	{
+		for (auto& stage : _stages)
+		{
+			std::fill(stage->input.begin(), stage->input.end(), ComplexT{ Real(0), Real(0) });
+			std::fill(stage->delayLine.begin(), stage->delayLine.end(), ComplexT{ Real(0), Real(0) });
+			stage->numPending = 0;
+			stage->head = 0;
+			stage->step = stage->numSteps;
+		}
+		std::fill(_outputRing.begin(), _outputRing.end(), ComplexT{ Real(0), Real(0) });
+		_position = 0;
+	}
+
+private:
+	//uniformly partitioned segment of kernel, taps offset .. offset + numPartitions * blockSize - 1
+	struct Stage
+	{
+		unsigned int blockSize{ 0 };
+		unsigned int offset{ 0 };
+		unsigned int numPartitions{ 0 };
+		FftPlanPtr<Real> forwardPlan;
+		FftPlanPtr<Real> inversePlan;
+		AlignedVector<ComplexT> kernelSpectra;	//partition after partition, 2 * blockSize bins each
+		AlignedVector<ComplexT> delayLine;		//ring of input spectra, head is newest
+		AlignedVector<ComplexT> accumulator;
+		std::vector<ComplexT> input;			//previous block followed by current one
+		unsigned int numPending{ 0 };
+		unsigned int head{ 0 };
+		unsigned int numSteps{ 1 };				//blocks of first stage one block of this stage is spread over
+		unsigned int step{ 1 };					//next step of block in flight, numSteps when idle
+		unsigned long long blockEnd{ 0 };		//position where input of block in flight completed
+	};
+
+	static unsigned int RoundUp(unsigned int size)
+	{
+		unsigned int result = 1;
+		while (result < size)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+	void BuildStages(const ComplexT* kernel, unsigned int largestBlock)
+	{
+		const unsigned int growth = 4;
+
+		unsigned int offset = 0;
+		unsigned int stageBlock = _blockSize;
+		while (offset < _kernelSize)
+		{
+			//stage ends where next one may start, last stage covers the rest
+			unsigned int end = _kernelSize;
+			if (stageBlock < largestBlock)
+			{
+				unsigned int nextBlock = stageBlock * growth;
+				unsigned int nextOffset = offset;
+				while (nextOffset < 2 * (nextBlock - _blockSize))
+				{
+					nextOffset += stageBlock;
+				}
+				end = (std::min)(nextOffset, _kernelSize);
+			}
+
+			AddStage(kernel, offset, end, stageBlock);
+
+			offset = end;
+			stageBlock = (std::min)(stageBlock * growth, largestBlock);
+		}
+	}
+
+	void AddStage(const ComplexT* kernel, unsigned int begin, unsigned int end, unsigned int blockSize)
+	{
+		std::unique_ptr<Stage> stage(new Stage());
+		unsigned int fftSize = 2 * blockSize;
+
+		stage->blockSize = blockSize;
+		stage->offset = begin;
+		stage->numSteps = blockSize / _blockSize;
+		stage->step = stage->numSteps;
+		stage->numPartitions = (end - begin + blockSize - 1) / blockSize;
+		stage->forwardPlan = GetFftPlan<Real>(fftSize, FftDirection::Forward);
+		stage->inversePlan = GetFftPlan<Real>(fftSize, FftDirection::Inverse);
+
+		//1/L of inverse transform is folded in
+		Real scale = Real(1) / fftSize;
+
+		stage->kernelSpectra.assign(static_cast<size_t>(stage->numPartitions) * fftSize, ComplexT{ Real(0), Real(0) });
+		for (unsigned int partition = 0; partition < stage->numPartitions; ++partition)
+		{
+			ComplexT* spectrum = stage->kernelSpectra.data() + static_cast<size_t>(partition) * fftSize;
+
+			unsigned int first = begin + partition * blockSize;
+			unsigned int last = (std::min)(first + blockSize, end);
+			for (unsigned int tap = first; tap < last; ++tap)
+			{
+				spectrum[tap - first] = { kernel[tap].first * scale, kernel[tap].second * scale };
+			}
+
+			stage->forwardPlan->Execute(spectrum);
+		}
+
+		stage->delayLine.resize(stage->kernelSpectra.size());
+		stage->accumulator.resize(fftSize);
+		stage->input.resize(fftSize);
+
+		_stages.push_back(std::move(stage));
+	}
+
+	void RunDueStages()
+	{
+		std::vector<Stage*>& due = _dueStages;
+		due.clear();
+
+		for (auto& stage : _stages)
+		{
+			//previous block of stage took its last step one block of first stage ago
+			if (stage->numPending == stage->blockSize)
+			{
+				stage->step = 0;
+				stage->blockEnd = _position;
+			}
+			if (stage->step < stage->numSteps)
+			{
+				due.push_back(stage.get());
+			}
+		}
+
+		if (due.size() == 1)
+		{
+			RunStep(*due[0]);
+		}
+		else
+		{
+			GetThreadPool().ParallelFor(static_cast<unsigned int>(due.size()), [&](unsigned int stageBegin, unsigned int stageEnd)
+			{
+				for (unsigned int index = stageBegin; index < stageEnd; ++index)
+				{
+					RunStep(*due[index]);
+				}
+			});
+		}
+
+		//output ranges of stages overlap, finished ones are added one after another
+		for (Stage* stage : due)
+		{
+			if (stage->step == stage->numSteps)
+			{
+				AddStageOutput(*stage);
+			}
+		}
+	}
+
+	void RunStep(Stage& stage)
+	{
+		unsigned int blockSize = stage.blockSize;
+		unsigned int fftSize = 2 * blockSize;
+		unsigned int numPartitions = stage.numPartitions;
+
+		if (stage.step == 0)
+		{
+			//newest input spectrum goes into slot of oldest one
+			stage.head = stage.head + 1 < numPartitions ? stage.head + 1 : 0;
+			stage.forwardPlan->Execute(stage.input.data(), stage.delayLine.data() + static_cast<size_t>(stage.head) * fftSize);
+
+			std::copy(stage.input.begin() + blockSize, stage.input.end(), stage.input.begin());
+			stage.numPending = 0;
+		}
+
+		//partition p meets input spectrum from p blocks ago, every step takes its own slice of bins,
+		//bins of slice are split across threads when delay line is long
+		unsigned int sliceSize = fftSize / stage.numSteps;
+		unsigned int sliceBegin = sliceSize * stage.step;
+		unsigned int minBins = (std::max)(64u, 65536u / numPartitions);
+		GetThreadPool().ParallelFor(sliceSize, [&](unsigned int binBegin, unsigned int binEnd)
+		{
+			binBegin += sliceBegin;
+			binEnd += sliceBegin;
+
+			std::fill(stage.accumulator.begin() + binBegin, stage.accumulator.begin() + binEnd, ComplexT{ Real(0), Real(0) });
+
+			unsigned int slot = stage.head;
+			for (unsigned int partition = 0; partition < numPartitions; ++partition)
+			{
+				const ComplexT* spectrum = stage.delayLine.data() + static_cast<size_t>(slot) * fftSize;
+				const ComplexT* kernelSpectrum = stage.kernelSpectra.data() + static_cast<size_t>(partition) * fftSize;
+
+				ComplexMultiplyAdd(spectrum + binBegin, kernelSpectrum + binBegin, stage.accumulator.data() + binBegin, binEnd - binBegin);
+
+				slot = slot > 0 ? slot - 1 : numPartitions - 1;
+			}
+		}, minBins);
+
+		if (++stage.step == stage.numSteps)
+		{
+			stage.inversePlan->Execute(stage.accumulator.data());
+		}
+	}
+
+	void AddStageOutput(const Stage& stage)
+	{
+		unsigned int blockSize = stage.blockSize;
+
+		//second half is free of circular wrap, it belongs to samples of block that finished at blockEnd
+		unsigned int mask = static_cast<unsigned int>(_outputRing.size()) - 1;
+		unsigned long long first = stage.blockEnd - blockSize + stage.offset;
+		for (unsigned int index = 0; index < blockSize; ++index)
+		{
+			ComplexT& value = _outputRing[(first + index) & mask];
+			const ComplexT& result = stage.accumulator[blockSize + index];
+			value = { value.first + result.first, value.second + result.second };
+		}
+	}
+
+	unsigned int _kernelSize{ 0 };
+	unsigned int _blockSize{ 0 };
+	std::vector<std::unique_ptr<Stage>> _stages;
+	std::vector<Stage*> _dueStages;
+	std::vector<ComplexT> _outputRing;
+	unsigned long long _position{ 0 };
+};
+
+using PartitionedConvolver = PartitionedConvolverT<float>;
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "Signal.h"
 #include "DFT.h"
 #include "Util.h"
+#include "Benchmark.h"
+#include "SlidingDFT.h"
+#include "Spectrum.h"
 
 struct SignalPlayground
 {
@@ -20,11 +23,7 @@ void DFTOnSignal(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottom
 	RawSignalPtr amplitudes = GetAmplitudesFromSignals(fCoefficients);
 
 
-	//todo FIX Inverse FT
-	//possible problemes:
-	//originals iterate to 2001 this to 2000
-	//wny inverse FT is not reconstructing phase ( TODO add code for phase)
-	RawSignalPtr reconstructedSignal = InverseFT2(fCoefficients);
+	RawSignalPtr reconstructedSignal = InverseFastFT(fCoefficients);
 
 	//draw signals at top slot
 	topSlot.AddSignal(move(sineSignalRaw));
@@ -51,7 +50,7 @@ void DFTOnSignalFast(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bo
 	RawSignalPtr fCoefficients = DiscreteFT2(*signal.get());
 	RawSignalPtr amplitudes = GetAmplitudesFromSignals(fCoefficients);
 
-	RawSignalPtr reconstructedSignal = InverseFT(fCoefficients);
+	RawSignalPtr reconstructedSignal = InverseFastFT(fCoefficients);
 
 	//draw signals at top slot
 	topSlot.AddSignal(move(signal));
@@ -68,50 +67,14 @@ void SimpleSignalFiltering(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSl
 	//do discrete fourier on signal					
 	RawSignalPtr sineSignalRaw = ToRawSignal({ &SineSignal{ 2.5f, 4.f, 0.f, 5 }, &SineSignal{ 1.5f, 6.5f, 0.f, 5 }, &SineSignal{ 1.5f, 16.5f, 0.f, 5 } });
 
-	unsigned int SignalSize = 3001;
-
-	RawSignalPtr fCoefficients = DiscreteFT(sineSignalRaw);
-
-	RawSignalPtr amplitudes = GetAmplitudesFromSignals(fCoefficients);
-
-	//remove two signals for 16.5 hz and 6 hz we will reconstruct with 4hz signal
-	auto GetIndexForFrequency = [&](float frequency)
-	{
-		//get frequency index location from signal lenght divided by sampling rate
-		float index = frequency * (sineSignalRaw->Size() / (float)sineSignalRaw->GetSamplingRate());
-		return (unsigned int)index;
-	};
-
-
-	//////remove 4hz signal
-	//unsigned int index4hz = GetIndexForFrequency(4.f);
-	//fCoefficients->_dataVec[index4hz] = { 0.f, 0.f };
-	//fCoefficients->_dataVec[SignalSize - index4hz] = { 0.f, 0.f };
-	//amplitudes->_dataVec[index4hz] = { 0.f, 0.f };
-	//amplitudes->_dataVec[SignalSize - index4hz] = { 0.f, 0.f };
+	Spectrum spectrum(DiscreteFT(sineSignalRaw));
 
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(spectrum.GetCoefficients());
 
-	//////remove 6.5 hz signal
-	//unsigned int index6hz = GetIndexForFrequency(6.5f);
-	//fCoefficients->_dataVec[index6hz] = { 0.f, 0.f };
-	//amplitudes->_dataVec[index6hz] = { 0.f, 0.f };
-	////hack 
-	//fCoefficients->_dataVec[20] = { 0.f, 0.f };
-	//amplitudes->_dataVec[20] = { 0.f, 0.f };
+	//remove two signals for 16.5 hz and 6.5 hz we will reconstruct with 4hz signal
+	//spectrum.Notch({ 6.5f, 16.5f });
 
-	//fCoefficients->_dataVec[SignalSize - index6hz] = { 0.f, 0.f };
-	//amplitudes->_dataVec[SignalSize - index6hz] = { 0.f, 0.f };
-	////hack
-	//fCoefficients->_dataVec[SignalSize - index6hz -1] = { 0.f, 0.f };
-	//amplitudes->_dataVec[SignalSize - index6hz - 1] = { 0.f, 0.f };
-
-
-
-	//todo FIX Inverse FT
-	//possible problemes:
-	//originals iterate to 2001 this to 2000
-	//wny inverse FT is not reconstructing phase ( TODO add code for phase)
-	RawSignalPtr reconstructedSignal = InverseFT(fCoefficients);
+	RawSignalPtr reconstructedSignal = InverseFastFT(spectrum.GetCoefficients());
 
 	//draw signals at top slot
 	topSlot.AddSignal(move(sineSignalRaw));
@@ -129,42 +92,46 @@ void SimpleSignalFilteringFast(SignalSlot& topSlot, SignalSlot& middleSlot, Sign
 
 	//TODO remove global sampling rate variable and use time func settings
 
-	unsigned int SignalSize = 2001;
 	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
 	SineSignal signal2{ 1.5f, 6.5f, 0.f, 3 };
 	SineSignal signal3{ 1.5f, 16.5f, 0.f, 3 };
 	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 3);
-	SignalSize = combinedSignal.GetSize();
 
 	//TODO fix combined signal calculations
-	RawSignalPtr fCoefficients = DiscreteFT2(combinedSignal);
+	Spectrum spectrum(DiscreteFT2(combinedSignal));
 	//
-	RawSignalPtr amplitudes = GetAmplitudesFromSignals(fCoefficients);
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(spectrum.GetCoefficients());
 
-	//remove two signals for 16.5 hz and 6 hz we will reconstruct with 4hz signal
-	auto GetIndexForFrequency = [&](float frequency)
-	{
-		//get frequency index location from signal lenght divided by sampling rate
-		float index = frequency * (SignalSize / (float)combinedSignal.GetSamplingRate());
-		return (unsigned int)index;
-	};
+	////remove 16.5hz and 6.5 hz signals
+	//spectrum.Notch({ 16.5f, 6.5f });
 
-	////remove 16.5hz signal
-	//unsigned int index4hz = GetIndexForFrequency(16.5f);
-	//fCoefficients->_dataVec[index4hz] = { 0.f, 0.f };
-	//fCoefficients->_dataVec[SignalSize - index4hz + 1] = { 0.f, 0.f };
+	RawSignalPtr reconstructedSignal = InverseFastFT(spectrum.GetCoefficients());
 
-	////remove 6.5 hz signal
-	//unsigned int index6hz = GetIndexForFrequency(6.5f);
-	//fCoefficients->_dataVec[index6hz] = { 0.f, 0.f };
-	//fCoefficients->_dataVec[SignalSize - index6hz + 1] = { 0.f, 0.f };
+	//draw signals at top slot
+	topSlot.AddSignal(ToRawSignal({ &combinedSignal }));
+
+	//draw signal amplitudes
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw signal amplitudes
+	bottomSlot.AddSignal(move(reconstructedSignal));
+}
+
+void FastFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 6.f, 0.f, 3 };
+	SineSignal signal3{ 1.5f, 16.f, 0.f, 3 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3  }, 3);
 
+	Spectrum spectrum(FastFT(ToRawSignal({ &combinedSignal })));
 
-	//todo FIX Inverse FT
-	//possible problemes:
-	//originals iterate to 2001 this to 2000
-	//wny inverse FT is not reconstructing phase ( TODO add code for phase)
-	RawSignalPtr reconstructedSignal = InverseFT2(fCoefficients);
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(spectrum.GetCoefficients());
+
+	//remove 16 hz and 4 hz signals, only their bins and mirrors are touched
+	spectrum.Notch({ 16.f, 4.f });
+
+	RawSignalPtr reconstructedSignal = InverseFastFT(spectrum.GetCoefficients());
 
 	//draw signals at top slot
 	topSlot.AddSignal(ToRawSignal({ &combinedSignal }));
@@ -176,37 +143,28 @@ void SimpleSignalFilteringFast(SignalSlot& topSlot, SignalSlot& middleSlot, Sign
 	bottomSlot.AddSignal(move(reconstructedSignal));
 }
 
-void FastFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+void RealFastFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
 {
-	//Fast FT works well with samples that are power of two
+	//signal is real so only half of spectrum is computed and filtered
 	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
 	SineSignal signal2{ 1.5f, 6.f, 0.f, 3 };
 	SineSignal signal3{ 1.5f, 16.f, 0.f, 3 };
-	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3  }, 3);
-	unsigned int SignalSize = combinedSignal.GetSize();
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 3);
 
-	RawSignalPtr fCoefficientsFast = FastFT(ToRawSignal({ &combinedSignal }));
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+	unsigned int SignalSize = signalRaw->Size();
 
-	//remove two signals for 16.5 hz and 6 hz we will reconstruct with 4hz signal
-	auto GetIndexForFrequency = [&](float frequency)
-	{
-		//get frequency index location from signal lenght divided by sampling rate
-		float index = frequency * (SignalSize / (float)combinedSignal.GetSamplingRate());
-		return (unsigned int)index;
-	};
+	Spectrum halfSpectrum(RealFastFT(signalRaw), SignalSize, SpectrumLayout::OneSided);
 
-	RawSignalPtr amplitudes = GetAmplitudesFromSignals(fCoefficientsFast);
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(halfSpectrum.GetCoefficients());
 
-	//remove 16.hz signal
-	RemoveSignalFrequency(fCoefficientsFast, 16.f, combinedSignal.GetLenght());
-	
-	//remove 4 hz signal
-	RemoveSignalFrequency(fCoefficientsFast, 4.f, combinedSignal.GetLenght());
+	//remove 16 hz and 4 hz signals
+	halfSpectrum.Notch({ 16.f, 4.f });
 
-	RawSignalPtr reconstructedSignal = InverseFT2(fCoefficientsFast);
+	RawSignalPtr reconstructedSignal = InverseRealFastFT(halfSpectrum.GetCoefficients(), SignalSize);
 
 	//draw signals at top slot
-	topSlot.AddSignal(ToRawSignal({ &combinedSignal }));
+	topSlot.AddSignal(move(signalRaw));
 
 	//draw signal amplitudes
 	middleSlot.AddSignal(move(amplitudes));
@@ -215,10 +173,400 @@ void FastFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bott
 	bottomSlot.AddSignal(move(reconstructedSignal));
 }
 
-void SignalPlayground::Play(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+void WindowedFastFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//6.5 hz falls between bins, rectangular window leaks it over whole spectrum, blackman-harris keeps it local
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 2 };
+	SineSignal signal2{ 0.05f, 16.f, 0.f, 2 };
+	SineSignal signal3{ 1.5f, 6.25f, 0.f, 2 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 2);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(FastFT(signalRaw));
+	RawSignalPtr windowedAmplitudes = GetAmplitudesFromSignals(FastFT(signalRaw, WindowType::BlackmanHarris));
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw leaking amplitudes, weak 16 hz tone is buried
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw windowed amplitudes
+	bottomSlot.AddSignal(move(windowedAmplitudes));
+}
+
+void FirFilteringExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
 {
-	//TODO: implement FFInverse
+	//low pass at 10 hz removes 16.5 hz tone in time domain, no ringing from zeroed bins
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 6.5f, 0.f, 3 };
+	SineSignal signal3{ 1.5f, 16.5f, 0.f, 3 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 3);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
 
+	std::vector<float> taps = DesignLowPass<float>(401, 10.0 / signalRaw->GetSamplingRate());
+	RawSignalPtr filteredSignal = FirFiltering(signalRaw, taps);
+
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(FastFT(filteredSignal, WindowType::Hann));
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw amplitudes of filtered signal
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw filtered signal, delayed by 200 samples
+	bottomSlot.AddSignal(move(filteredSignal));
+}
+
+void ClockDriftExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//same 3 second tone captured by device whose clock runs at 1000.37 hz instead of 1000 hz,
+	//drift is removed by farrow resampler and last 0.25 sample of misalignment by fractional delay
+	const double deviceRate = 1000.37;
+	const unsigned int samplingRate = 1000;
+	const unsigned int signalSize = 3 * samplingRate + 1;
+
+	RawSignalPtr reference(new RawSignal(signalSize, samplingRate));
+	RawSignalPtr capture(new RawSignal(static_cast<unsigned int>(3 * deviceRate) + 1, samplingRate));
+	for (unsigned int index = 0; index < signalSize; ++index)
+	{
+		float time = (float)index / samplingRate;
+		reference->_dataVec[index] = { 2.5f * sinf(2.f * PI * 4.f * time) + 1.5f * sinf(2.f * PI * 16.5f * time), 0.f };
+		reference->_timeVec[index] = time;
+	}
+	for (unsigned int index = 0; index < capture->Size(); ++index)
+	{
+		//capture also starts quarter of sample early
+		float time = (float)((index + 0.25) / deviceRate);
+		capture->_dataVec[index] = { 2.5f * sinf(2.f * PI * 4.f * time) + 1.5f * sinf(2.f * PI * 16.5f * time), 0.f };
+		capture->_timeVec[index] = (float)index / samplingRate;
+	}
+
+	RawSignalPtr corrected = DelaySignal(FarrowResample(capture, deviceRate, samplingRate), 0.25);
+
+	RawSignalPtr difference(new RawSignal(signalSize, samplingRate));
+	for (unsigned int index = 0; index < signalSize && index < corrected->Size(); ++index)
+	{
+		difference->_dataVec[index] = { reference->_dataVec[index].first - corrected->_dataVec[index].first, 0.f };
+		difference->_timeVec[index] = reference->_timeVec[index];
+	}
+
+	//draw capture as it came from device at top slot
+	topSlot.AddSignal(move(capture));
+
+	//draw corrected capture
+	middleSlot.AddSignal(move(corrected));
+
+	//draw what is left after subtracting reference
+	bottomSlot.AddSignal(move(difference));
+}
+
+void ResampleExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//same 3 seconds at 1000, 250 and 2400 items per second, every slot is drawn at rate of its signal
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 16.5f, 0.f, 3 };
+	CombinedSignal combinedSignal({ &signal1, &signal2 }, 3);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+
+	RawSignalPtr downsampled = Resample(signalRaw, 250);
+	RawSignalPtr upsampled = Resample(signalRaw, 2400);
+	std::cout << signalRaw->Size() << " items at " << signalRaw->GetSamplingRate() << " hz, "
+		<< downsampled->Size() << " at " << downsampled->GetSamplingRate() << " hz, "
+		<< upsampled->Size() << " at " << upsampled->GetSamplingRate() << " hz\n";
+
+	//draw signal at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw downsampled signal
+	middleSlot.AddSignal(move(downsampled));
+
+	//draw upsampled signal
+	bottomSlot.AddSignal(move(upsampled));
+}
+
+void ReverbExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//2 second decaying noise impulse response applied in blocks of 64 samples, latency stays 64 samples
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 1 };
+	SineSignal signal2{ 1.5f, 16.5f, 0.f, 1 };
+	CombinedSignal combinedSignal({ &signal1, &signal2 }, 1);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+	unsigned int samplingRate = signalRaw->GetSamplingRate();
+
+	RawSignalPtr impulseResponse(new RawSignal(2 * samplingRate));
+	for (unsigned int index = 0; index < impulseResponse->Size(); ++index)
+	{
+		float time = (float)index / samplingRate;
+		float noise = (float)rand() / RAND_MAX - 0.5f;
+		impulseResponse->_dataVec[index] = { noise * expf(-3.f * time) * 0.05f, 0.f };
+		impulseResponse->_timeVec[index] = time;
+	}
+	impulseResponse->_dataVec[0] = { 1.f, 0.f };
+
+	RawSignalPtr reverb = PartitionedConvolution(signalRaw, impulseResponse, 64, 1024);
+
+	//draw dry signal at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw impulse response
+	middleSlot.AddSignal(move(impulseResponse));
+
+	//draw signal with reverb tail
+	bottomSlot.AddSignal(move(reverb));
+}
+
+void BiquadNotchExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//16.5 hz notch and 1 hz high pass fed block by block, state carries over so blocks join without clicks
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 6.5f, 0.f, 3 };
+	SineSignal signal3{ 1.5f, 16.5f, 0.f, 3 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 3);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+	float samplingRate = (float)signalRaw->GetSamplingRate();
+
+	BiquadCascade cascade({ DesignBiquadNotch(16.5 / samplingRate, 5.0), DesignBiquadHighPass(1.0 / samplingRate) }, 2);
+
+	const unsigned int blockSize = 250;
+	RawSignalPtr filteredSignal(new RawSignal(signalRaw->Size(), signalRaw->GetSamplingRate()));
+	for (unsigned int blockStart = 0; blockStart < signalRaw->Size(); blockStart += blockSize)
+	{
+		unsigned int blockEnd = (std::min)(blockStart + blockSize, signalRaw->Size());
+
+		RawSignalPtr block(new RawSignal(blockEnd - blockStart, signalRaw->GetSamplingRate()));
+		std::copy(signalRaw->_dataVec.begin() + blockStart, signalRaw->_dataVec.begin() + blockEnd, block->_dataVec.begin());
+		std::copy(signalRaw->_timeVec.begin() + blockStart, signalRaw->_timeVec.begin() + blockEnd, block->_timeVec.begin());
+
+		RawSignalPtr filteredBlock = BiquadFiltering(cascade, block);
+		std::copy(filteredBlock->_dataVec.begin(), filteredBlock->_dataVec.end(), filteredSignal->_dataVec.begin() + blockStart);
+		std::copy(filteredBlock->_timeVec.begin(), filteredBlock->_timeVec.end(), filteredSignal->_timeVec.begin() + blockStart);
+	}
+
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(FastFT(filteredSignal, WindowType::Hann));
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw amplitudes of filtered signal
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw filtered signal
+	bottomSlot.AddSignal(move(filteredSignal));
+}
+
+void ToneDetectionExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//only tones of interest are evaluated, no full spectrum
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 6.5f, 0.f, 3 };
+	SineSignal signal3{ 1.5f, 16.5f, 0.f, 3 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 3);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+
+	std::vector<float> frequencies{ 4.f, 6.5f, 10.f, 16.5f };
+	std::vector<Complex> coefficients = GoertzelFT(signalRaw, frequencies);
+
+	for (size_t index = 0; index < frequencies.size(); ++index)
+	{
+		//same amplitude as GetAmplitudesFromSignals
+		float amplitude = 2.f * ComplexMagnitude(coefficients[index]);
+		std::cout << frequencies[index] << " hz amplitude " << amplitude << (amplitude > 0.5f ? " present\n" : " absent\n");
+	}
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+}
+
+void SlidingDFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//16 hz tone starts after first second, its bin is tracked sample by sample
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 16.f, 0.f, 3 };
+	RawSignalPtr signalRaw = ToRawSignal({ &signal1 });
+	RawSignalPtr toneRaw = ToRawSignal({ &signal2 });
+
+	unsigned int SignalSize = signalRaw->Size();
+	for (unsigned int index = signalRaw->GetSamplingRate(); index < SignalSize; ++index)
+	{
+		signalRaw->_dataVec[index].first += toneRaw->_dataVec[index].first;
+	}
+
+	//one second window so bin number equals frequency in hz
+	SlidingDFT slidingDft(signalRaw->GetSamplingRate(), { 4, 16 }, 0.99999);
+
+	RawSignalPtr baseAmplitude(new RawSignal(SignalSize));
+	RawSignalPtr toneAmplitude(new RawSignal(SignalSize));
+	for (unsigned int index = 0; index < SignalSize; ++index)
+	{
+		slidingDft.Push(signalRaw->_dataVec[index]);
+
+		baseAmplitude->_timeVec[index] = signalRaw->_timeVec[index];
+		baseAmplitude->_dataVec[index].first = 2.f * ComplexMagnitude(slidingDft.GetValue(0));
+
+		toneAmplitude->_timeVec[index] = signalRaw->_timeVec[index];
+		toneAmplitude->_dataVec[index].first = 2.f * ComplexMagnitude(slidingDft.GetValue(1));
+	}
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw 4 hz amplitude over time
+	middleSlot.AddSignal(move(baseAmplitude));
+
+	//draw 16 hz amplitude over time
+	bottomSlot.AddSignal(move(toneAmplitude));
+}
+
+void ZoomFTExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//6.5 hz and 16.5 hz fall between bins of 1 second signal, zoomed spectrum resolves them without padding
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 1 };
+	SineSignal signal2{ 1.5f, 6.5f, 0.f, 1 };
+	SineSignal signal3{ 1.5f, 16.5f, 0.f, 1 };
+	CombinedSignal combinedSignal({ &signal1, &signal2, &signal3 }, 1);
+
+	RawSignalPtr signalRaw = ToRawSignal({ &combinedSignal });
+
+	RawSignalPtr fCoefficients = FastFT(signalRaw);
+	RawSignalPtr zoomedCoefficients = ZoomFT(signalRaw, 2.f, 20.f, 1000);
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw signal amplitudes
+	middleSlot.AddSignal(GetAmplitudesFromSignals(fCoefficients));
+
+	//draw zoomed amplitudes
+	bottomSlot.AddSignal(GetAmplitudesFromSignals(zoomedCoefficients));
+}
+
+void SpectrogramExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//16 hz tone starts after first second, short frames show when it appears
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 3 };
+	SineSignal signal2{ 1.5f, 16.f, 0.f, 3 };
+	RawSignalPtr signalRaw = ToRawSignal({ &signal1 });
+	RawSignalPtr toneRaw = ToRawSignal({ &signal2 });
+
+	unsigned int SignalSize = signalRaw->Size();
+	for (unsigned int index = signalRaw->GetSamplingRate(); index < SignalSize; ++index)
+	{
+		signalRaw->_dataVec[index].first += toneRaw->_dataVec[index].first;
+	}
+
+	const unsigned int frameSize = 250;
+	const unsigned int hop = 50;
+	std::vector<Spectrum> frames = ShortTimeFT(signalRaw, frameSize, hop, WindowType::Hann);
+
+	//one item per frame, frame rate keeps its seconds as wide as those of input
+	RawSignalPtr toneAmplitude(new RawSignal(static_cast<unsigned int>(frames.size()), signalRaw->GetSamplingRate() / hop));
+	for (unsigned int frame = 0; frame < frames.size(); ++frame)
+	{
+		const Spectrum& spectrum = frames[frame];
+
+		//time of frame center
+		toneAmplitude->_timeVec[frame] = (float)(frame * hop + frameSize / 2) / signalRaw->GetSamplingRate();
+		toneAmplitude->_dataVec[frame].first = 2.f * ComplexMagnitude(spectrum[spectrum.GetBin(16.f)]);
+	}
+
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(frames.back().GetCoefficients());
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw amplitudes of last frame
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw 16 hz amplitude over time
+	bottomSlot.AddSignal(move(toneAmplitude));
+}
+
+void NoiseFloorExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//16 hz tone in white noise, single periodogram is as noisy as input, welch average shows flat floor
+	SineSignal signal1{ 1.5f, 16.f, 0.f, 20 };
+	RawSignalPtr signalRaw = ToRawSignal({ &signal1 });
+
+	for (auto& sample : signalRaw->_dataVec)
+	{
+		sample.first += (float)rand() / RAND_MAX - 0.5f;
+	}
+
+	const unsigned int segmentSize = 500;
+	RawSignalPtr psd = WelchPSD(signalRaw, segmentSize, segmentSize / 2, WindowType::Hann);
+
+	//periodogram of first segment alone, positive bins only so it has same bins as psd
+	RawSignalPtr segment(new RawSignal(segmentSize, signalRaw->GetSamplingRate()));
+	std::copy(signalRaw->_timeVec.begin(), signalRaw->_timeVec.begin() + segmentSize, segment->_timeVec.begin());
+	std::copy(signalRaw->_dataVec.begin(), signalRaw->_dataVec.begin() + segmentSize, segment->_dataVec.begin());
+
+	RawSignalPtr amplitudes = GetAmplitudesFromSignals(FastFT(segment, WindowType::Hann));
+	amplitudes->_timeVec.resize(psd->Size());
+	amplitudes->_dataVec.resize(psd->Size());
+
+	//draw signals at top slot
+	topSlot.AddSignal(move(signalRaw));
+
+	//draw single periodogram amplitudes
+	middleSlot.AddSignal(move(amplitudes));
+
+	//draw averaged power spectral density
+	bottomSlot.AddSignal(move(psd));
+}
+
+void CorrelationExample(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
+	//1 second pattern hidden in 3 second capture, correlation peak gives its delay
+	SineSignal signal1{ 2.5f, 4.f, 0.f, 1 };
+	SineSignal signal2{ 1.5f, 16.5f, 0.f, 1 };
+	CombinedSignal combinedSignal({ &signal1, &signal2 }, 1);
+
+	RawSignalPtr pattern = ToRawSignal({ &combinedSignal });
+	unsigned int PatternSize = pattern->Size();
+
+	unsigned int delay = pattern->GetSamplingRate() + pattern->GetSamplingRate() / 4;
+	RawSignalPtr capture(new RawSignal(3 * pattern->GetSamplingRate() + 1));
+	for (unsigned int index = 0; index < capture->Size(); ++index)
+	{
+		capture->_timeVec[index] = (float)index / capture->GetSamplingRate();
+	}
+	for (unsigned int index = 0; index < PatternSize; ++index)
+	{
+		capture->_dataVec[delay + index] = pattern->_dataVec[index];
+	}
+
+	RawSignalPtr correlation = FastCrossCorrelation(capture, pattern);
+
+	unsigned int peak = 0;
+	for (unsigned int index = 0; index < correlation->Size(); ++index)
+	{
+		if (correlation->_dataVec[index].first > correlation->_dataVec[peak].first)
+		{
+			peak = index;
+		}
+	}
+	std::cout << "pattern found at " << correlation->_timeVec[peak] << " s\n";
+
+	//draw capture at top slot
+	topSlot.AddSignal(move(capture));
+
+	//draw pattern
+	middleSlot.AddSignal(move(pattern));
+
+	//draw correlation over lag
+	bottomSlot.AddSignal(move(correlation));
+}
+
+void SignalPlayground::Play(SignalSlot& topSlot, SignalSlot& middleSlot, SignalSlot& bottomSlot)
+{
 	////DFTOnSignalFast(topSlot, middleSlot, bottomSlot);
 	//{
 	//	MeasureExecution<> measure("SimpleSignalFiltering");
@@ -235,5 +583,39 @@ void SignalPlayground::Play(SignalSlot& topSlot, SignalSlot& middleSlot, SignalS
 		MeasureExecution<> measure("FastFT signal processing");
 		FastFTExample(topSlot, middleSlot, bottomSlot);
 	}
+
+	//{
+	//	MeasureExecution<> measure("RealFastFT signal processing");
+	//	RealFastFTExample(topSlot, middleSlot, bottomSlot);
+	//}
+
+	//FftBenchmark();
+
+	//WindowedFastFTExample(topSlot, middleSlot, bottomSlot);
+
+	//FirFilteringExample(topSlot, middleSlot, bottomSlot);
+
+	//BiquadNotchExample(topSlot, middleSlot, bottomSlot);
+
+	//ReverbExample(topSlot, middleSlot, bottomSlot);
+
+	//ResampleExample(topSlot, middleSlot, bottomSlot);
+
+	//ClockDriftExample(topSlot, middleSlot, bottomSlot);
+
+	//{
+	//	MeasureExecution<std::chrono::microseconds> measure("Goertzel tone detection");
+	//	ToneDetectionExample(topSlot, middleSlot, bottomSlot);
+	//}
+
+	//SlidingDFTExample(topSlot, middleSlot, bottomSlot);
+
+	//ZoomFTExample(topSlot, middleSlot, bottomSlot);
+
+	//CorrelationExample(topSlot, middleSlot, bottomSlot);
+
+	//SpectrogramExample(topSlot, middleSlot, bottomSlot);
+
+	//NoiseFloorExample(topSlot, middleSlot, bottomSlot);
 	
 }
@@ -0,0 +1,160 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <math.h>
+#include "ThreadPool.h"
+
+//DFT that computes only chosen output bins, O(N) per bin with no FFT and no per bin allocation
+//twiddle of bin k at sample n comes from recurrence p(n+1) = p(n) * exp(-i2PIk/N) kept in double,
+//every resyncInterval samples phasor is set exactly from (k*n) mod N so error does not grow with N
+//all bins of chunk advance together per sample so inner loop vectorizes, chunks of bins are spread across thread pool
+template<typename Real>
+class PrunedDftT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	PrunedDftT(unsigned int size, const std::vector<unsigned int>& bins) :
+		_size(size),
+		_bins(bins)
+	{
+		BuildSteps();
+	}
+
+	//numBins consecutive bins starting at firstBin
+	PrunedDftT(unsigned int size, unsigned int firstBin, unsigned int numBins) :
+		_size(size)
+	{
+		_bins.resize(numBins);
+		for (unsigned int index = 0; index < numBins; ++index)
+		{
+			_bins[index] = firstBin + index;
+		}
+		BuildSteps();
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	unsigned int GetNumBins() const
+	{
+		return static_cast<unsigned int>(_bins.size());
+	}
+
+	//input has GetSize() samples, output[j] receives bin GetBins()[j], no 1/N scaling like forward FFT
+	void Execute(const ComplexT* input, ComplexT* output) const
+	{
+		Run(input, output);
+	}
+
+	void Execute(const Real* input, ComplexT* output) const
+	{
+		Run(input, output);
+	}
+
+	const std::vector<unsigned int>& GetBins() const
+	{
+		return _bins;
+	}
+
+private:
+	static const unsigned int resyncInterval = 1024;
+	static const unsigned int binChunk = 64;
+
+	static std::pair<double, double> ToComplex(const ComplexT& sample)
+	{
+		return { sample.first, sample.second };
+	}
+
+	static std::pair<double, double> ToComplex(Real sample)
+	{
+		return { sample, 0.0 };
+	}
+
+	void BuildSteps()
+	{
+		const double twoPi = 6.283185307179586476925;
+
+		_stepReal.resize(_bins.size());
+		_stepImg.resize(_bins.size());
+		for (size_t index = 0; index < _bins.size(); ++index)
+		{
+			double angle = _size != 0 ? -twoPi * (_bins[index] % _size) / _size : 0.0;
+			_stepReal[index] = cos(angle);
+			_stepImg[index] = sin(angle);
+		}
+	}
+
+	template<typename Sample>
+	void Run(const Sample* input, ComplexT* output) const
+	{
+		unsigned int numBins = GetNumBins();
+		unsigned int numChunks = (numBins + binChunk - 1) / binChunk;
+
+		GetThreadPool().ParallelFor(numChunks, [&](unsigned int chunkBegin, unsigned int chunkEnd)
+		{
+			for (unsigned int chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+			{
+				unsigned int binBegin = chunk * binChunk;
+				unsigned int binEnd = numBins - binBegin < binChunk ? numBins : binBegin + binChunk;
+				RunChunk(input, binBegin, binEnd, output);
+			}
+		});
+	}
+
+	template<typename Sample>
+	void RunChunk(const Sample* input, unsigned int binBegin, unsigned int binEnd, ComplexT* output) const
+	{
+		const double twoPi = 6.283185307179586476925;
+		unsigned int count = binEnd - binBegin;
+
+		double phasorReal[binChunk];
+		double phasorImg[binChunk];
+		double sumReal[binChunk] = {};
+		double sumImg[binChunk] = {};
+		const double* stepReal = _stepReal.data() + binBegin;
+		const double* stepImg = _stepImg.data() + binBegin;
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			if (index % resyncInterval == 0)
+			{
+				for (unsigned int bin = 0; bin < count; ++bin)
+				{
+					unsigned long long exponent = (static_cast<unsigned long long>(_bins[binBegin + bin]) * index) % _size;
+					double angle = -twoPi * exponent / _size;
+					phasorReal[bin] = cos(angle);
+					phasorImg[bin] = sin(angle);
+				}
+			}
+
+			std::pair<double, double> sample = ToComplex(input[index]);
+
+			for (unsigned int bin = 0; bin < count; ++bin)
+			{
+				double real = phasorReal[bin];
+				double img = phasorImg[bin];
+
+				sumReal[bin] += sample.first * real - sample.second * img;
+				sumImg[bin] += sample.first * img + sample.second * real;
+
+				phasorReal[bin] = real * stepReal[bin] - img * stepImg[bin];
+				phasorImg[bin] = real * stepImg[bin] + img * stepReal[bin];
+			}
+		}
+
+		for (unsigned int bin = 0; bin < count; ++bin)
+		{
+			output[binBegin + bin] = { static_cast<Real>(sumReal[bin]), static_cast<Real>(sumImg[bin]) };
+		}
+	}
+
+	unsigned int _size{ 0 };
+	std::vector<unsigned int> _bins;
+	std::vector<double> _stepReal;
+	std::vector<double> _stepImg;
+};
+
+using PrunedDft = PrunedDftT<float>;
\ No newline at end of file
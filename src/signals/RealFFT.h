@@ -0,0 +1,245 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <algorithm>
+#include "FFTPlan.h"
+
+//real input FFT, N real samples are packed into N/2 complex samples (even samples real, odd samples imaginary)
+//and transformed with half size complex plan, hermitian symmetry X[N-k] = conj(X[k]) is used to split
+//the result so only N/2+1 non redundant bins are produced, odd N uses full size complex plan
+template<typename Real>
+class RealFftPlanT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//even sizes use packed half size plan, odd sizes fall back to full size complex plan
+	RealFftPlanT(unsigned int size) :
+		_size(size),
+		_forwardPlan(GetFftPlan<Real>(IsPacked(size) ? size / 2 : size, FftDirection::Forward)),
+		_inversePlan(GetFftPlan<Real>(IsPacked(size) ? size / 2 : size, FftDirection::Inverse))
+	{
+		BuildTwiddles();
+	}
+
+	unsigned int GetSize() const
+	{
+		return _size;
+	}
+
+	unsigned int GetSpectrumSize() const
+	{
+		return _size / 2 + 1;
+	}
+
+	//number of items Forward and Inverse need in scratch buffer
+	unsigned int GetScratchSize() const
+	{
+		return _forwardPlan->GetSize() + _forwardPlan->GetScratchSize();
+	}
+
+	static bool IsSupportedSize(unsigned int size)
+	{
+		return FftPlanT<Real>::IsSupportedSize(size);
+	}
+
+	//input has GetSize() samples, spectrum receives GetSpectrumSize() bins, no 1/N scaling
+	void Forward(const Real* input, ComplexT* spectrum, ComplexT* scratch) const
+	{
+		if (!IsPacked(_size))
+		{
+			ForwardFull(input, spectrum, scratch);
+			return;
+		}
+
+		unsigned int halfSize = _size / 2;
+
+		//pack even and odd samples into one complex sequence
+		for (unsigned int index = 0; index < halfSize; ++index)
+		{
+			spectrum[index] = { input[2 * index], input[2 * index + 1] };
+		}
+
+		_forwardPlan->ExecuteInPlace(spectrum, scratch);
+
+		//dc and nyquist bins are both made of bin 0
+		ComplexT first = spectrum[0];
+		spectrum[0] = { first.first + first.second, Real(0) };
+		spectrum[halfSize] = { first.first - first.second, Real(0) };
+
+		//split remaining bins in pairs k and halfSize-k so the transform can be finished in place
+		for (unsigned int k = 1; k <= halfSize / 2; ++k)
+		{
+			unsigned int mirror = halfSize - k;
+			ComplexT zk = spectrum[k];
+			ComplexT zm = spectrum[mirror];
+
+			spectrum[k] = SplitBin(zk, zm, _twiddles[k]);
+			if (mirror != k)
+			{
+				spectrum[mirror] = SplitBin(zm, zk, _twiddles[mirror]);
+			}
+		}
+	}
+
+	//same as above with per thread scratch buffer
+	void Forward(const Real* input, ComplexT* spectrum) const
+	{
+		Forward(input, spectrum, GetThreadScratch());
+	}
+
+	//spectrum has GetSpectrumSize() bins, output receives GetSize() samples scaled by N like inverse complex plan
+	void Inverse(const ComplexT* spectrum, Real* output, ComplexT* scratch) const
+	{
+		if (!IsPacked(_size))
+		{
+			InverseFull(spectrum, output, scratch);
+			return;
+		}
+
+		unsigned int halfSize = _size / 2;
+
+		for (unsigned int k = 0; k < halfSize; ++k)
+		{
+			const ComplexT& xk = spectrum[k];
+			const ComplexT& xm = spectrum[halfSize - k];
+
+			//even part X[k] + conj(X[M-k]) and odd part (X[k] - conj(X[M-k])) * conj(W^k)
+			Real evenReal = xk.first + xm.first;
+			Real evenImg = xk.second - xm.second;
+			Real diffReal = xk.first - xm.first;
+			Real diffImg = xk.second + xm.second;
+
+			const ComplexT& twiddle = _twiddles[k];
+			Real oddReal = diffReal * twiddle.first + diffImg * twiddle.second;
+			Real oddImg = diffImg * twiddle.first - diffReal * twiddle.second;
+
+			//even + i * odd
+			scratch[k] = { evenReal - oddImg, evenImg + oddReal };
+		}
+
+		_inversePlan->ExecuteInPlace(scratch, scratch + halfSize);
+
+		for (unsigned int index = 0; index < halfSize; ++index)
+		{
+			output[2 * index] = scratch[index].first;
+			output[2 * index + 1] = scratch[index].second;
+		}
+	}
+
+	//same as above with per thread scratch buffer
+	void Inverse(const ComplexT* spectrum, Real* output) const
+	{
+		Inverse(spectrum, output, GetThreadScratch());
+	}
+
+private:
+	static bool IsPacked(unsigned int size)
+	{
+		return size >= 2 && (size % 2) == 0;
+	}
+
+	ComplexT* GetThreadScratch() const
+	{
+		thread_local std::vector<ComplexT> scratch;
+		if (scratch.size() < GetScratchSize())
+		{
+			scratch.resize(GetScratchSize());
+		}
+
+		return scratch.data();
+	}
+
+	void ForwardFull(const Real* input, ComplexT* spectrum, ComplexT* scratch) const
+	{
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			scratch[index] = { input[index], Real(0) };
+		}
+
+		_forwardPlan->ExecuteInPlace(scratch, scratch + _size);
+
+		std::copy(scratch, scratch + GetSpectrumSize(), spectrum);
+	}
+
+	void InverseFull(const ComplexT* spectrum, Real* output, ComplexT* scratch) const
+	{
+		//rebuild upper half from X[N-k] = conj(X[k])
+		unsigned int spectrumSize = GetSpectrumSize();
+		std::copy(spectrum, spectrum + spectrumSize, scratch);
+		for (unsigned int k = spectrumSize; k < _size; ++k)
+		{
+			scratch[k] = { spectrum[_size - k].first, -spectrum[_size - k].second };
+		}
+
+		_inversePlan->ExecuteInPlace(scratch, scratch + _size);
+
+		for (unsigned int index = 0; index < _size; ++index)
+		{
+			output[index] = scratch[index].first;
+		}
+	}
+
+	void BuildTwiddles()
+	{
+		if (!IsPacked(_size))
+		{
+			return;
+		}
+
+		const double twoPi = 6.283185307179586476925;
+		unsigned int halfSize = _size / 2;
+
+		_twiddles.resize(halfSize + 1);
+		for (unsigned int k = 0; k <= halfSize; ++k)
+		{
+			double angle = -twoPi * k / _size;
+			_twiddles[k] = { static_cast<Real>(cos(angle)), static_cast<Real>(sin(angle)) };
+		}
+	}
+
+	//X[k] = E[k] + W^k * O[k], E = (Z[k] + conj(Z[M-k]))/2, O = -i * (Z[k] - conj(Z[M-k]))/2
+	static ComplexT SplitBin(const ComplexT& zk, const ComplexT& zm, const ComplexT& twiddle)
+	{
+		Real evenReal = Real(0.5) * (zk.first + zm.first);
+		Real evenImg = Real(0.5) * (zk.second - zm.second);
+		Real oddReal = Real(0.5) * (zk.second + zm.second);
+		Real oddImg = Real(-0.5) * (zk.first - zm.first);
+
+		Real rotatedReal = twiddle.first * oddReal - twiddle.second * oddImg;
+		Real rotatedImg = twiddle.first * oddImg + twiddle.second * oddReal;
+
+		return { evenReal + rotatedReal, evenImg + rotatedImg };
+	}
+
+	unsigned int _size{ 0 };
+	FftPlanPtr<Real> _forwardPlan;
+	FftPlanPtr<Real> _inversePlan;
+	std::vector<ComplexT> _twiddles;
+};
+
+using RealFftPlan = RealFftPlanT<float>;
+using RealFftPlanDouble = RealFftPlanT<double>;
+
+template<typename Real>
+using RealFftPlanPtr = std::shared_ptr<const RealFftPlanT<Real>>;
+
+//shared read only real plan, cached same way as GetFftPlan
+template<typename Real = float>
+RealFftPlanPtr<Real> GetRealFftPlan(unsigned int size)
+{
+	static std::mutex cacheMutex;
+	static std::map<unsigned int, RealFftPlanPtr<Real>> cache;
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto& plan = cache[size];
+	if (!plan)
+	{
+		plan = std::make_shared<const RealFftPlanT<Real>>(size);
+	}
+
+	return plan;
+}
@@ -0,0 +1,242 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include "FIR.h"
+
+template<typename Real>
+using PolyphaseBankPtr = std::shared_ptr<const AlignedVector<Real>>;
+
+inline unsigned int GreatestCommonDivisor(unsigned int a, unsigned int b)
+{
+	while (b != 0)
+	{
+		unsigned int rest = a % b;
+		a = b;
+		b = rest;
+	}
+	return a;
+}
+
+//number of prototype taps of bank, odd so delay of prototype is whole number of upsampled samples
+inline unsigned int GetPolyphasePrototypeSize(unsigned int up, unsigned int tapsPerPhase)
+{
+	unsigned int numTaps = up * tapsPerPhase;
+	return numTaps % 2 == 0 ? numTaps - 1 : numTaps;
+}
+
+//returns shared read only filter bank for resampling by up / down (reduced), banks are built on first use
+//and cached for lifetime of the program so streams of same ratio share them
+//prototype is Kaiser windowed sinc at upsampled rate cutting off at 0.45 of lower of both rates,
+//phase p holds taps p, p + up, p + 2 up ... reversed and scaled by up, phase after phase, tapsPerPhase each
+template<typename Real>
+PolyphaseBankPtr<Real> GetPolyphaseBank(unsigned int up, unsigned int down, unsigned int tapsPerPhase)
+{
+	using BankKey = std::tuple<unsigned int, unsigned int, unsigned int>;
+	static std::mutex cacheMutex;
+	static std::map<BankKey, PolyphaseBankPtr<Real>> cache;
+
+	BankKey key{ up, down, tapsPerPhase };
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto found = cache.find(key);
+	if (found != cache.end())
+	{
+		return found->second;
+	}
+
+	unsigned int numTaps = GetPolyphasePrototypeSize(up, tapsPerPhase);
+	double cutoff = 0.45 / (std::max)(up, down);
+	std::vector<double> prototype = DesignLowPass<double>(numTaps, cutoff, WindowType::Kaiser);
+
+	std::shared_ptr<AlignedVector<Real>> bank = std::make_shared<AlignedVector<Real>>(static_cast<size_t>(up) * tapsPerPhase, Real(0));
+	for (unsigned int phase = 0; phase < up; ++phase)
+	{
+		for (unsigned int index = 0; index < tapsPerPhase; ++index)
+		{
+			unsigned int tap = phase + index * up;
+			if (tap < numTaps)
+			{
+				(*bank)[static_cast<size_t>(phase) * tapsPerPhase + tapsPerPhase - 1 - index] = static_cast<Real>(prototype[tap] * up);
+			}
+		}
+	}
+
+	cache.insert({ key, bank });
+	return bank;
+}
+
+//rational sample rate conversion by up / down with polyphase filter bank, channels with shared state kept between blocks
+//output m lies at upsampled time delay + m * down where delay is group delay of prototype, so output m is at
+//input time m * down / up exactly and comes out once input runs delay / up samples past it
+//every output is one vectorized dot product of tapsPerPhase taps of its phase with contiguous input history,
+//zero stuffed samples are never multiplied and dropped outputs are never computed
+//outputs of block are independent of each other and are spread across thread pool
+template<typename Real>
+class PolyphaseResamplerT
+{
+public:
+	//up and down are reduced by their greatest common divisor, target and source rates can be passed as they are
+	//tapsPerPhase is quality, it grows by down / up for decimation so filter keeps its length in input samples
+	PolyphaseResamplerT(unsigned int up, unsigned int down, unsigned int numChannels = 1, unsigned int tapsPerPhase = 32) :
+		_numChannels(numChannels)
+	{
+		unsigned int divisor = GreatestCommonDivisor(up, down);
+		_up = divisor != 0 ? up / divisor : 1;
+		_down = divisor != 0 ? down / divisor : 1;
+		_up = _up != 0 ? _up : 1;
+		_down = _down != 0 ? _down : 1;
+
+		unsigned int stretch = (_down + _up - 1) / _up;
+		_tapsPerPhase = (tapsPerPhase != 0 ? tapsPerPhase : 1) * stretch;
+
+		_bank = GetPolyphaseBank<Real>(_up, _down, _tapsPerPhase);
+		_delay = (GetPolyphasePrototypeSize(_up, _tapsPerPhase) - 1) / 2;
+
+		_buffers.resize(_numChannels);
+		for (auto& buffer : _buffers)
+		{
+			buffer.resize(_tapsPerPhase - 1 + chunkSize);
+		}
+		Reset();
+	}
+
+	unsigned int GetUpFactor() const
+	{
+		return _up;
+	}
+
+	unsigned int GetDownFactor() const
+	{
+		return _down;
+	}
+
+	unsigned int GetTapsPerPhase() const
+	{
+		return _tapsPerPhase;
+	}
+
+	unsigned int GetNumChannels() const
+	{
+		return _numChannels;
+	}
+
+	//input samples output lags behind, group delay of prototype
+	double GetLatency() const
+	{
+		return static_cast<double>(_delay) / _up;
+	}
+
+	//outputs per channel next Process call of count samples writes
+	unsigned int GetOutputCount(unsigned int count) const
+	{
+		return CountOutputs(_inputIndex, _phase, count);
+	}
+
+	//count samples of every channel, output channels need GetOutputCount(count) items, returns outputs per channel
+	unsigned int Process(const Real* const* input, unsigned int count, Real* const* output)
+	{
+		unsigned int written = 0;
+		unsigned int history = _tapsPerPhase - 1;
+
+		for (unsigned int done = 0; done < count; )
+		{
+			unsigned int numSamples = count - done < chunkSize ? count - done : chunkSize;
+			unsigned int numOutputs = CountOutputs(_inputIndex, _phase, numSamples);
+
+			for (unsigned int channel = 0; channel < _numChannels; ++channel)
+			{
+				std::copy(input[channel] + done, input[channel] + done + numSamples, _buffers[channel].begin() + history);
+			}
+
+			//output n of chunk reads input at upsampled position phase + n * down past first input of chunk
+			unsigned long long firstIndex = _inputIndex;
+			unsigned long long firstPhase = _phase;
+			GetThreadPool().ParallelFor(numOutputs, [&](unsigned int outputBegin, unsigned int outputEnd)
+			{
+				for (unsigned int channel = 0; channel < _numChannels; ++channel)
+				{
+					const Real* buffer = _buffers[channel].data();
+					Real* channelOutput = output[channel] + written;
+
+					for (unsigned int index = outputBegin; index < outputEnd; ++index)
+					{
+						unsigned long long position = firstPhase + static_cast<unsigned long long>(index) * _down;
+						unsigned long long inputIndex = firstIndex + position / _up;
+						unsigned int phase = static_cast<unsigned int>(position % _up);
+
+						channelOutput[index] = Dot(_bank->data() + static_cast<size_t>(phase) * _tapsPerPhase, buffer + inputIndex, _tapsPerPhase);
+					}
+				}
+			}, 256);
+
+			unsigned long long position = firstPhase + static_cast<unsigned long long>(numOutputs) * _down;
+			_inputIndex = firstIndex + position / _up - numSamples;
+			_phase = static_cast<unsigned int>(position % _up);
+
+			//last samples become history of next chunk
+			for (auto& buffer : _buffers)
+			{
+				std::copy(buffer.begin() + numSamples, buffer.begin() + numSamples + history, buffer.begin());
+			}
+
+			written += numOutputs;
+			done += numSamples;
+		}
+
+		return written;
+	}
+
+	//single channel conversion
+	unsigned int Process(const Real* input, unsigned int count, Real* output)
+	{
+		return Process(&input, count, &output);
+	}
+
+	void Reset()
+	{
+		for (auto& buffer : _buffers)
+		{
+			std::fill(buffer.begin(), buffer.end(), Real(0));
+		}
+
+		//first output waits for input at group delay so it lands on time of first input sample
+		_inputIndex = _delay / _up;
+		_phase = _delay % _up;
+	}
+
+private:
+	static const unsigned int chunkSize = 4096;
+
+	//outputs n >= 0 whose newest input inputIndex + (phase + n * down) / up is below count
+	unsigned int CountOutputs(unsigned long long inputIndex, unsigned int phase, unsigned int count) const
+	{
+		if (inputIndex >= count)
+		{
+			return 0;
+		}
+
+		unsigned long long span = (count - inputIndex) * _up - phase;
+		return static_cast<unsigned int>((span + _down - 1) / _down);
+	}
+
+	unsigned int _up{ 1 };
+	unsigned int _down{ 1 };
+	unsigned int _numChannels{ 0 };
+	unsigned int _tapsPerPhase{ 0 };
+	unsigned int _delay{ 0 };
+	PolyphaseBankPtr<Real> _bank;
+	std::vector<AlignedVector<Real>> _buffers;
+
+	//newest input of next output relative to first sample of next block, and its upsampled phase
+	unsigned long long _inputIndex{ 0 };
+	unsigned int _phase{ 0 };
+};
+
+using PolyphaseResampler = PolyphaseResamplerT<float>;
\ No newline at end of file
@@ -0,0 +1,253 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "FFTPlan.h"
+#include "ThreadPool.h"
+#include "WindowFunctions.h"
+
+//short time fourier transform, frame k covers samples k * hop .. k * hop + frameSize - 1
+//frames are windowed and scaled by 1 / sum(window) so sine of amplitude A gives |X| = A/2 like FastFT,
+//scaling is folded into window table which plan applies while gathering input, framing costs no extra pass
+//streaming: Push takes blocks of any length, finished frames go into preallocated ring of spectra,
+//when ring is full oldest frames are overwritten so memory stays constant for captures of any length
+//batch: Execute transforms all frames of whole signal, frames are spread across thread pool
+template<typename Real>
+class StftT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//ringSize is number of frames kept for reader, negative windowParameter picks default of window type
+	StftT(unsigned int frameSize, unsigned int hopSize, WindowType window = WindowType::Rectangular, unsigned int ringSize = 64, double windowParameter = -1.0) :
+		_frameSize(frameSize),
+		_hopSize(hopSize != 0 ? hopSize : 1),
+		_ringSize(ringSize != 0 ? ringSize : 1)
+	{
+		_plan = GetFftPlan<Real>(_frameSize, FftDirection::Forward);
+
+		BuildWindow(*GetWindow<Real>(window, _frameSize, windowParameter));
+
+		_input.resize(_frameSize);
+		_ring.resize(static_cast<size_t>(_ringSize) * _frameSize);
+		Reset();
+	}
+
+	unsigned int GetFrameSize() const
+	{
+		return _frameSize;
+	}
+
+	unsigned int GetHopSize() const
+	{
+		return _hopSize;
+	}
+
+	unsigned int GetRingSize() const
+	{
+		return _ringSize;
+	}
+
+	//number of whole frames in signal of signalSize samples
+	unsigned int GetFrameCount(unsigned int signalSize) const
+	{
+		return signalSize >= _frameSize ? (signalSize - _frameSize) / _hopSize + 1 : 0;
+	}
+
+	//all frames of whole signal, output has GetFrameCount(size) * GetFrameSize() items, frame after frame
+	//does not touch streaming state
+	void Execute(const ComplexT* input, unsigned int size, ComplexT* output) const
+	{
+		Run(input, size, output);
+	}
+
+	void Execute(const Real* input, unsigned int size, ComplexT* output) const
+	{
+		Run(input, size, output);
+	}
+
+	//streaming input, returns number of frames finished by this block
+	unsigned int Push(const ComplexT* input, unsigned int count)
+	{
+		return Stream(input, count);
+	}
+
+	unsigned int Push(const Real* input, unsigned int count)
+	{
+		return Stream(input, count);
+	}
+
+	//frames waiting in ring
+	unsigned int GetNumFrames() const
+	{
+		return _numFrames;
+	}
+
+	//frames overwritten before they were popped since last Reset
+	unsigned long long GetNumDroppedFrames() const
+	{
+		return _numDropped;
+	}
+
+	//index 0 is oldest waiting frame, GetFrameSize() bins
+	const ComplexT* GetFrame(unsigned int index) const
+	{
+		return _ring.data() + static_cast<size_t>(RingSlot(index)) * _frameSize;
+	}
+
+	//number of first input sample of frame
+	unsigned long long GetFrameStart(unsigned int index) const
+	{
+		return (_numEmitted - _numFrames + index) * _hopSize;
+	}
+
+	void PopFrames(unsigned int count)
+	{
+		count = (std::min)(count, _numFrames);
+		_firstFrame = (_firstFrame + count) % _ringSize;
+		_numFrames -= count;
+	}
+
+	void Reset()
+	{
+		std::fill(_input.begin(), _input.end(), ComplexT{ Real(0), Real(0) });
+		_numBuffered = 0;
+		_numSkipped = 0;
+		_firstFrame = 0;
+		_numFrames = 0;
+		_numEmitted = 0;
+		_numDropped = 0;
+	}
+
+private:
+	static ComplexT ToComplex(const ComplexT& sample)
+	{
+		return sample;
+	}
+
+	static ComplexT ToComplex(Real sample)
+	{
+		return { sample, Real(0) };
+	}
+
+	void BuildWindow(const AlignedVector<Real>& window)
+	{
+		_window = window;
+
+		double sum = GetWindowSum(_window.data(), _frameSize);
+		Real scale = sum != 0.0 ? static_cast<Real>(1.0 / sum) : Real(1);
+		for (auto& value : _window)
+		{
+			value *= scale;
+		}
+	}
+
+	void Transform(const ComplexT* samples, ComplexT* spectrum) const
+	{
+		_plan->ExecuteWindowed(samples, _window.data(), spectrum);
+	}
+
+	//real samples have to be widened to complex anyway, window is applied in same loop
+	void Transform(const Real* samples, ComplexT* spectrum) const
+	{
+		for (unsigned int index = 0; index < _frameSize; ++index)
+		{
+			spectrum[index] = { samples[index] * _window[index], Real(0) };
+		}
+		_plan->Execute(spectrum);
+	}
+
+	unsigned int RingSlot(unsigned int index) const
+	{
+		return (_firstFrame + index) % _ringSize;
+	}
+
+	template<typename Sample>
+	void Run(const Sample* input, unsigned int size, ComplexT* output) const
+	{
+		unsigned int numFrames = GetFrameCount(size);
+
+		GetThreadPool().ParallelFor(numFrames, [&](unsigned int frameBegin, unsigned int frameEnd)
+		{
+			for (unsigned int frame = frameBegin; frame < frameEnd; ++frame)
+			{
+				const Sample* samples = input + static_cast<size_t>(frame) * _hopSize;
+				ComplexT* spectrum = output + static_cast<size_t>(frame) * _frameSize;
+
+				Transform(samples, spectrum);
+			}
+		});
+	}
+
+	template<typename Sample>
+	unsigned int Stream(const Sample* input, unsigned int count)
+	{
+		unsigned int numFinished = 0;
+
+		for (unsigned int index = 0; index < count; ++index)
+		{
+			//hop longer than frame leaves gaps between frames
+			if (_numSkipped > 0)
+			{
+				--_numSkipped;
+				continue;
+			}
+
+			_input[_numBuffered] = ToComplex(input[index]);
+			if (++_numBuffered == _frameSize)
+			{
+				EmitFrame();
+				++numFinished;
+			}
+		}
+
+		return numFinished;
+	}
+
+	void EmitFrame()
+	{
+		if (_numFrames == _ringSize)
+		{
+			_firstFrame = (_firstFrame + 1) % _ringSize;
+			--_numFrames;
+			++_numDropped;
+		}
+
+		ComplexT* spectrum = _ring.data() + static_cast<size_t>(RingSlot(_numFrames)) * _frameSize;
+		Transform(_input.data(), spectrum);
+
+		++_numFrames;
+		++_numEmitted;
+
+		//keep overlap with next frame
+		if (_hopSize < _frameSize)
+		{
+			std::copy(_input.begin() + _hopSize, _input.end(), _input.begin());
+			_numBuffered = _frameSize - _hopSize;
+		}
+		else
+		{
+			_numBuffered = 0;
+			_numSkipped = _hopSize - _frameSize;
+		}
+	}
+
+	unsigned int _frameSize{ 0 };
+	unsigned int _hopSize{ 0 };
+	unsigned int _ringSize{ 0 };
+	FftPlanPtr<Real> _plan;
+	AlignedVector<Real> _window;
+
+	std::vector<ComplexT> _input;
+	unsigned int _numBuffered{ 0 };
+	unsigned int _numSkipped{ 0 };
+
+	std::vector<ComplexT> _ring;
+	unsigned int _firstFrame{ 0 };
+	unsigned int _numFrames{ 0 };
+	unsigned long long _numEmitted{ 0 };
+	unsigned long long _numDropped{ 0 };
+};
+
+using Stft = StftT<float>;
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Complex.h"
 
 static const float PI = 3.14159265f;
+//rate of signals that are not given one, RawSignal carries its own
 static const unsigned int SamplingRate = 1000;
 
 struct StandartTimeFunc
@@ -28,12 +29,8 @@ struct StandartTimeFunc
 		//size is not calculated precompute 
 		if (_size == 0)
 		{
-			//round to power of two 
-			unsigned int sizeNeeded = SamplingRate * NumSeconds + 1;
-
-			auto sizeNeededMagnitudeOfTwo = log2(sizeNeeded);
-			auto magnitudeOfTwo = std::ceil(sizeNeededMagnitudeOfTwo);
-			_size = static_cast<unsigned int>(std::pow(2, magnitudeOfTwo));
+			//FFT handles any size, no padding to power of two
+			_size = SamplingRate * NumSeconds + 1;
 		}
 
 		return _size;
@@ -78,7 +75,7 @@ public:
 		return _signalLenght;
 	}
 
-	unsigned int GetSize() const
+	virtual unsigned int GetSize() const
 	{
 		return _timeFunction->GetSize();
 	}
@@ -117,8 +114,12 @@ struct RawSignal : public Signal
 
 	RawSignal() :RawSignal(0) {}
 
-	RawSignal(unsigned int size) :Signal(size / SamplingRate)
+	RawSignal(unsigned int size) :RawSignal(size, SamplingRate) {}
+
+	//samplingRate is items per second, lenght in seconds is derived from it
+	RawSignal(unsigned int size, unsigned int samplingRate) :Signal(samplingRate != 0 ? size / samplingRate : 0)
 	{
+		_timeFunction->SamplingRate = samplingRate;
 		_timeVec.resize(size);
 		_dataVec.resize(size);
 	}
@@ -128,6 +129,12 @@ struct RawSignal : public Signal
 		return static_cast<unsigned int>(_timeVec.size());
 	}
 
+	//items actually held, not rate times whole seconds
+	unsigned int GetSize() const override
+	{
+		return static_cast<unsigned int>(_timeVec.size());
+	}
+
 	float GetTime(unsigned int index) const
 	{
 		return _timeVec[index];
@@ -255,9 +262,14 @@ public:
 		return _amlitiude * sin(2 * PI * _frequency * time + _phase);
 	}
 
-	std::unique_ptr<RawSignal> ToRawSignal()
+	//one period of time 0..1 is split into numItems items, 0 takes item count of default rate,
+	//transforms pass size of signal they work on so reference has as many items as it
+	std::unique_ptr<RawSignal> ToRawSignal(unsigned int numItems = 0)
 	{
-		unsigned int numItems = _signalLenght * this->_timeFunction->SamplingRate + 1;
+		if (numItems == 0)
+		{
+			numItems = _signalLenght * this->_timeFunction->SamplingRate + 1;
+		}
 		float timeStep = (float)_signalLenght / numItems;
 
 		std::unique_ptr < RawSignal> result(new RawSignal());
@@ -277,21 +289,24 @@ public:
 		return result;
 	}
 
-	std::unique_ptr<RawSignal> ToRawSignalAndMultiply(std::pair<float, float> multiplier = { 1.f, 1.f })
+	//numItems same as in ToRawSignal
+	std::unique_ptr<RawSignal> ToRawSignalAndMultiply(std::pair<float, float> multiplier = { 1.f, 1.f }, unsigned int numItems = 0)
 	{
 		auto z = std::numeric_limits<unsigned int>::max;
 
 		FourierTimeFunc fTF{ _timeFunction->SamplingRate, _signalLenght };
 
-		unsigned int numItems = fTF.GetSize();
+		if (numItems == 0)
+		{
+			numItems = fTF.GetSize();
+		}
 
 		float timeStep = (float)_signalLenght / numItems;
 
 		std::unique_ptr < RawSignal> result(new RawSignal(numItems));
 		for (unsigned int i = 0; i < numItems; ++i)
 		{
-			//float time = (float)i / (numItems);
-			float time = fTF.GetTime(i);
+			float time = (float)i / (numItems);
 
 			float value = Evaluate(time);
 			float value2 = Evaluate2(time);
@@ -316,10 +331,17 @@ struct SignalSlot
 	std::pair<float, float> RelativePosition{ 0.f, 5.f };
 	std::vector < SignalPtr > _signals;
 	unsigned int _signalLenght{ 0 };
+	unsigned int _samplingRate{ 0 };
 
+	//signals are drawn item by item at rate of first signal, signals of other rates have to be resampled first
 	void AddSignal(SignalPtr&& signal)
 	{
-		_signalLenght = max(signal->GetLenght() * signal->GetSamplingRate(), _signalLenght);
+		if (_samplingRate == 0)
+		{
+			_samplingRate = signal->GetSamplingRate();
+		}
+		//item count, signals shorter than one second are drawn as well
+		_signalLenght = max(signal->GetSize(), _signalLenght);
 		_signals.push_back(move(signal));
 	}
 
@@ -328,6 +350,11 @@ struct SignalSlot
 		return _signalLenght;
 	}
 
+	unsigned int GetSamplingRate() const
+	{
+		return _samplingRate != 0 ? _samplingRate : SamplingRate;
+	}
+
 	float evaluate(unsigned int index)
 	{
 		float val = 0.f;
@@ -361,13 +388,15 @@ inline RawSignalPtr ToRawSignal(std::initializer_list<const Signal*> signals)
 {
 	unsigned int signalLenghtSeconds = 0;
 	unsigned int numItems = 0;
+	unsigned int samplingRate = 0;
 	for (const auto& signal : signals)
 	{
 		signalLenghtSeconds = max(signal->GetLenght(), signalLenghtSeconds);
 		numItems = max((unsigned int)signal->GetSize(), numItems);
+		samplingRate = max(signal->GetSamplingRate(), samplingRate);
 	}
 
-	RawSignalPtr result(new RawSignal(numItems));
+	RawSignalPtr result(new RawSignal(numItems, samplingRate));
 	float timeStep = (float)signalLenghtSeconds / numItems;
 
 	for (unsigned int index = 0; index < numItems; ++index)
@@ -0,0 +1,1029 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIGNALS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define SIGNALS_X86 0
+#endif
+
+//msvc allows any intrinsic in any function, gcc and clang need target attribute per function
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SIGNALS_TARGET_AVX2
+#define SIGNALS_TARGET_AVX512
+#else
+#define SIGNALS_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIGNALS_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+enum class SimdLevel
+{
+	Scalar = 0,
+	Sse2 = 1,	//4 floats
+	Avx2 = 2,	//8 floats
+	Avx512 = 3	//16 floats
+};
+
+//allocator for SIMD tables, default alignment is one cache line
+template<typename T, size_t Alignment = 64>
+struct AlignedAllocator
+{
+	using value_type = T;
+
+	template<typename U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() {}
+
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+	T* allocate(size_t count)
+	{
+#if defined(_MSC_VER)
+		void* memory = _aligned_malloc(count * sizeof(T), Alignment);
+#else
+		void* memory = nullptr;
+		if (posix_memalign(&memory, Alignment, count * sizeof(T)) != 0)
+		{
+			memory = nullptr;
+		}
+#endif
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(memory);
+	}
+
+	void deallocate(T* memory, size_t)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(memory);
+#else
+		free(memory);
+#endif
+	}
+
+	template<typename U>
+	bool operator==(const AlignedAllocator<U, Alignment>&) const
+	{
+		return true;
+	}
+
+	template<typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment>&) const
+	{
+		return false;
+	}
+};
+
+template<typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+inline SimdLevel DetectSimdLevel()
+{
+#if SIGNALS_X86
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool hasSse2 = (info[3] & (1 << 26)) != 0;
+	bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+	bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+	//os has to save ymm (bits 1, 2) and zmm (bits 5, 6, 7) registers on context switch
+	unsigned long long xcr0 = hasOsxsave ? _xgetbv(0) : 0;
+	bool osYmm = (xcr0 & 0x6) == 0x6;
+	bool osZmm = (xcr0 & 0xE6) == 0xE6;
+
+	bool hasAvx2 = false;
+	bool hasAvx512 = false;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		hasAvx2 = (info[1] & (1 << 5)) != 0;
+		hasAvx512 = (info[1] & (1 << 16)) != 0;
+	}
+
+	if (hasAvx512 && hasAvx && osZmm)
+	{
+		return SimdLevel::Avx512;
+	}
+	if (hasAvx2 && hasAvx && osYmm)
+	{
+		return SimdLevel::Avx2;
+	}
+	return hasSse2 ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return SimdLevel::Avx512;
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SimdLevel::Avx2;
+	}
+	return __builtin_cpu_supports("sse2") ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#endif
+#else
+	return SimdLevel::Scalar;
+#endif
+}
+
+//highest level kernels may use, lowered by SetSimdLevelLimit to compare implementations
+inline std::atomic<int>& SimdLevelLimit()
+{
+	static std::atomic<int> limit{ static_cast<int>(SimdLevel::Avx512) };
+	return limit;
+}
+
+inline void SetSimdLevelLimit(SimdLevel level)
+{
+	SimdLevelLimit() = static_cast<int>(level);
+}
+
+//detected once, later calls only apply limit
+inline SimdLevel GetSimdLevel()
+{
+	static const SimdLevel detected = DetectSimdLevel();
+
+	int limit = SimdLevelLimit();
+	return static_cast<int>(detected) < limit ? detected : static_cast<SimdLevel>(limit);
+}
+
+//number of floats processed by one instruction at given level
+inline unsigned int GetSimdWidth(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::Sse2:
+		return 4;
+	case SimdLevel::Avx2:
+		return 8;
+	case SimdLevel::Avx512:
+		return 16;
+	default:
+		return 1;
+	}
+}
+
+//twiddle tables of split complex power of two transform
+//re/im:         stage with halfStage items, item k at [halfStage + k] = W_2h^k
+//cubeRe/cubeIm: radix-4 pass starting at halfStage, item k at [halfStage + k] = W_4h^3k
+//rotation:      W_4 = i * rotation, -1 for forward and 1 for inverse transform
+template<typename Real>
+struct SplitTwiddles
+{
+	const Real* re;
+	const Real* im;
+	const Real* cubeRe;
+	const Real* cubeIm;
+	Real rotation;
+};
+
+//fills tables of SplitTwiddles for size items, cube table is filled for every halfStage so passes may start anywhere
+template<typename Real, typename Allocator>
+void BuildSplitTwiddles(unsigned int size, double sign, std::vector<Real, Allocator>& re, std::vector<Real, Allocator>& im,
+	std::vector<Real, Allocator>& cubeRe, std::vector<Real, Allocator>& cubeIm)
+{
+	const double twoPi = 6.283185307179586476925;
+
+	re.assign(size, Real(0));
+	im.assign(size, Real(0));
+	cubeRe.assign(size, Real(0));
+	cubeIm.assign(size, Real(0));
+
+	for (unsigned int halfStage = 1; halfStage < size; halfStage <<= 1)
+	{
+		for (unsigned int k = 0; k < halfStage; ++k)
+		{
+			//computed in double so large sizes do not lose precision
+			double angle = sign * twoPi * k / (2.0 * halfStage);
+			re[halfStage + k] = static_cast<Real>(cos(angle));
+			im[halfStage + k] = static_cast<Real>(sin(angle));
+
+			double cubeAngle = sign * twoPi * 3.0 * k / (4.0 * halfStage);
+			cubeRe[halfStage + k] = static_cast<Real>(cos(cubeAngle));
+			cubeIm[halfStage + k] = static_cast<Real>(sin(cubeAngle));
+		}
+	}
+}
+
+//split complex radix-2 stage
+template<typename Real>
+void SplitRadix2StageScalar(Real* re, Real* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<Real>& twiddles)
+{
+	const Real* wr = twiddles.re + halfStage;
+	const Real* wi = twiddles.im + halfStage;
+
+	for (unsigned int blockStart = 0; blockStart < size; blockStart += 2 * halfStage)
+	{
+		Real* evenRe = re + blockStart;
+		Real* evenIm = im + blockStart;
+		Real* oddRe = evenRe + halfStage;
+		Real* oddIm = evenIm + halfStage;
+
+		for (unsigned int k = 0; k < halfStage; ++k)
+		{
+			Real tr = oddRe[k] * wr[k] - oddIm[k] * wi[k];
+			Real ti = oddRe[k] * wi[k] + oddIm[k] * wr[k];
+
+			oddRe[k] = evenRe[k] - tr;
+			oddIm[k] = evenIm[k] - ti;
+			evenRe[k] += tr;
+			evenIm[k] += ti;
+		}
+	}
+}
+
+//radix-4 pass replacing radix-2 stages halfStage and 2*halfStage on bit reversed data
+//with w = W_4h^k inputs a1, a2, a3 are rotated by w^2, w, w^3 so 3 complex multiplies cover 4 items instead of 4
+template<typename Real>
+void SplitRadix4PassScalar(Real* re, Real* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<Real>& twiddles)
+{
+	const Real* w1r = twiddles.re + 2 * halfStage;
+	const Real* w1i = twiddles.im + 2 * halfStage;
+	const Real* w2r = twiddles.re + halfStage;
+	const Real* w2i = twiddles.im + halfStage;
+	const Real* w3r = twiddles.cubeRe + halfStage;
+	const Real* w3i = twiddles.cubeIm + halfStage;
+	const Real rotation = twiddles.rotation;
+
+	for (unsigned int blockStart = 0; blockStart < size; blockStart += 4 * halfStage)
+	{
+		Real* r0 = re + blockStart; Real* r1 = r0 + halfStage; Real* r2 = r1 + halfStage; Real* r3 = r2 + halfStage;
+		Real* i0 = im + blockStart; Real* i1 = i0 + halfStage; Real* i2 = i1 + halfStage; Real* i3 = i2 + halfStage;
+
+		for (unsigned int k = 0; k < halfStage; ++k)
+		{
+			Real u1r = r1[k] * w2r[k] - i1[k] * w2i[k], u1i = r1[k] * w2i[k] + i1[k] * w2r[k];
+			Real u2r = r2[k] * w1r[k] - i2[k] * w1i[k], u2i = r2[k] * w1i[k] + i2[k] * w1r[k];
+			Real u3r = r3[k] * w3r[k] - i3[k] * w3i[k], u3i = r3[k] * w3i[k] + i3[k] * w3r[k];
+
+			Real sr = r0[k] + u1r, si = i0[k] + u1i;
+			Real dr = r0[k] - u1r, di = i0[k] - u1i;
+			Real pr = u2r + u3r, pi = u2i + u3i;
+			//(u2 - u3) * W_4
+			Real mr = -rotation * (u2i - u3i), mi = rotation * (u2r - u3r);
+
+			r0[k] = sr + pr; i0[k] = si + pi;
+			r2[k] = sr - pr; i2[k] = si - pi;
+			r1[k] = dr + mr; i1[k] = di + mi;
+			r3[k] = dr - mr; i3[k] = di - mi;
+		}
+	}
+}
+
+#if SIGNALS_X86
+
+//same as SplitRadix4PassScalar, halfStage has to be multiple of vector width
+#define SIGNALS_RADIX4_PASS(VEC, LOAD, STORE, ADD, SUB, MUL, SET1, WIDTH)								\
+	const float* w1r = twiddles.re + 2 * halfStage;														\
+	const float* w1i = twiddles.im + 2 * halfStage;														\
+	const float* w2r = twiddles.re + halfStage;															\
+	const float* w2i = twiddles.im + halfStage;															\
+	const float* w3r = twiddles.cubeRe + halfStage;														\
+	const float* w3i = twiddles.cubeIm + halfStage;														\
+	const VEC rotation = SET1(twiddles.rotation);														\
+	const VEC negRotation = SET1(-twiddles.rotation);													\
+	for (unsigned int blockStart = 0; blockStart < size; blockStart += 4 * halfStage)					\
+	{																									\
+		float* r0 = re + blockStart; float* r1 = r0 + halfStage; float* r2 = r1 + halfStage; float* r3 = r2 + halfStage;	\
+		float* i0 = im + blockStart; float* i1 = i0 + halfStage; float* i2 = i1 + halfStage; float* i3 = i2 + halfStage;	\
+		for (unsigned int k = 0; k < halfStage; k += WIDTH)												\
+		{																								\
+			VEC ar = LOAD(r1 + k), ai = LOAD(i1 + k), wr = LOAD(w2r + k), wi = LOAD(w2i + k);			\
+			VEC u1r = SUB(MUL(ar, wr), MUL(ai, wi)), u1i = ADD(MUL(ar, wi), MUL(ai, wr));				\
+			ar = LOAD(r2 + k); ai = LOAD(i2 + k); wr = LOAD(w1r + k); wi = LOAD(w1i + k);				\
+			VEC u2r = SUB(MUL(ar, wr), MUL(ai, wi)), u2i = ADD(MUL(ar, wi), MUL(ai, wr));				\
+			ar = LOAD(r3 + k); ai = LOAD(i3 + k); wr = LOAD(w3r + k); wi = LOAD(w3i + k);				\
+			VEC u3r = SUB(MUL(ar, wr), MUL(ai, wi)), u3i = ADD(MUL(ar, wi), MUL(ai, wr));				\
+			ar = LOAD(r0 + k); ai = LOAD(i0 + k);														\
+			VEC sr = ADD(ar, u1r), si = ADD(ai, u1i), dr = SUB(ar, u1r), di = SUB(ai, u1i);			\
+			VEC pr = ADD(u2r, u3r), pi = ADD(u2i, u3i);													\
+			VEC mr = MUL(negRotation, SUB(u2i, u3i)), mi = MUL(rotation, SUB(u2r, u3r));				\
+			STORE(r0 + k, ADD(sr, pr)); STORE(i0 + k, ADD(si, pi));										\
+			STORE(r2 + k, SUB(sr, pr)); STORE(i2 + k, SUB(si, pi));										\
+			STORE(r1 + k, ADD(dr, mr)); STORE(i1 + k, ADD(di, mi));										\
+			STORE(r3 + k, SUB(dr, mr)); STORE(i3 + k, SUB(di, mi));										\
+		}																								\
+	}
+
+#define SIGNALS_RADIX2_STAGE(VEC, LOAD, STORE, ADD, SUB, MUL, WIDTH)									\
+	const float* wr = twiddles.re + halfStage;															\
+	const float* wi = twiddles.im + halfStage;															\
+	for (unsigned int blockStart = 0; blockStart < size; blockStart += 2 * halfStage)					\
+	{																									\
+		float* er = re + blockStart; float* ei = im + blockStart;										\
+		float* odr = er + halfStage; float* odi = ei + halfStage;										\
+		for (unsigned int k = 0; k < halfStage; k += WIDTH)												\
+		{																								\
+			VEC xr = LOAD(odr + k), xi = LOAD(odi + k), twr = LOAD(wr + k), twi = LOAD(wi + k);			\
+			VEC tr = SUB(MUL(xr, twr), MUL(xi, twi)), ti = ADD(MUL(xr, twi), MUL(xi, twr));			\
+			VEC yr = LOAD(er + k), yi = LOAD(ei + k);													\
+			STORE(er + k, ADD(yr, tr)); STORE(ei + k, ADD(yi, ti));										\
+			STORE(odr + k, SUB(yr, tr)); STORE(odi + k, SUB(yi, ti));									\
+		}																								\
+	}
+
+inline void SplitRadix2StageSse2(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX2_STAGE(__m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, 4)
+}
+
+inline void SplitRadix4PassSse2(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX4_PASS(__m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_set1_ps, 4)
+}
+
+SIGNALS_TARGET_AVX2 inline void SplitRadix2StageAvx2(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX2_STAGE(__m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, 8)
+}
+
+SIGNALS_TARGET_AVX2 inline void SplitRadix4PassAvx2(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX4_PASS(__m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_set1_ps, 8)
+}
+
+SIGNALS_TARGET_AVX512 inline void SplitRadix2StageAvx512(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX2_STAGE(__m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, 16)
+}
+
+SIGNALS_TARGET_AVX512 inline void SplitRadix4PassAvx512(float* re, float* im, unsigned int size, unsigned int halfStage, const SplitTwiddles<float>& twiddles)
+{
+	SIGNALS_RADIX4_PASS(__m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_set1_ps, 16)
+}
+
+#undef SIGNALS_RADIX4_PASS
+#undef SIGNALS_RADIX2_STAGE
+
+#endif
+
+//all butterfly stages of bit reversed split complex data, radix-4 passes with one radix-2 stage at the end when needed
+//passes narrower than vector run scalar, wider ones run vectorized
+//firstHalfStage skips earlier stages, used when every item is a group of independent lanes
+template<typename Real>
+void SplitButterfliesScalar(Real* re, Real* im, unsigned int size, const SplitTwiddles<Real>& twiddles, unsigned int firstHalfStage = 1)
+{
+	unsigned int halfStage = firstHalfStage;
+	for (; halfStage * 2 < size; halfStage <<= 2)
+	{
+		SplitRadix4PassScalar(re, im, size, halfStage, twiddles);
+	}
+	if (halfStage < size)
+	{
+		SplitRadix2StageScalar(re, im, size, halfStage, twiddles);
+	}
+}
+
+inline void SplitButterflies(float* re, float* im, unsigned int size, const SplitTwiddles<float>& twiddles, unsigned int firstHalfStage = 1)
+{
+	SimdLevel level = GetSimdLevel();
+	unsigned int width = GetSimdWidth(level);
+
+#if SIGNALS_X86
+	typedef void(*StageKernel)(float*, float*, unsigned int, unsigned int, const SplitTwiddles<float>&);
+	StageKernel radix2 = nullptr;
+	StageKernel radix4 = nullptr;
+
+	switch (level)
+	{
+	case SimdLevel::Sse2:
+		radix2 = SplitRadix2StageSse2;
+		radix4 = SplitRadix4PassSse2;
+		break;
+	case SimdLevel::Avx2:
+		radix2 = SplitRadix2StageAvx2;
+		radix4 = SplitRadix4PassAvx2;
+		break;
+	case SimdLevel::Avx512:
+		radix2 = SplitRadix2StageAvx512;
+		radix4 = SplitRadix4PassAvx512;
+		break;
+	default:
+		break;
+	}
+
+	if (radix2 != nullptr)
+	{
+		unsigned int halfStage = firstHalfStage;
+		for (; halfStage * 2 < size; halfStage <<= 2)
+		{
+			if (halfStage >= width)
+			{
+				radix4(re, im, size, halfStage, twiddles);
+			}
+			else
+			{
+				SplitRadix4PassScalar(re, im, size, halfStage, twiddles);
+			}
+		}
+		if (halfStage < size)
+		{
+			if (halfStage >= width)
+			{
+				radix2(re, im, size, halfStage, twiddles);
+			}
+			else
+			{
+				SplitRadix2StageScalar(re, im, size, halfStage, twiddles);
+			}
+		}
+		return;
+	}
+#endif
+
+	SplitButterfliesScalar(re, im, size, twiddles, firstHalfStage);
+}
+
+//double precision has no vector kernels
+inline void SplitButterflies(double* re, double* im, unsigned int size, const SplitTwiddles<double>& twiddles, unsigned int firstHalfStage = 1)
+{
+	SplitButterfliesScalar(re, im, size, twiddles, firstHalfStage);
+}
+
+//true when SplitButterflies has vector kernels for given precision on this cpu
+template<typename Real>
+inline bool HasSimdButterflies()
+{
+	return false;
+}
+
+template<>
+inline bool HasSimdButterflies<float>()
+{
+	return GetSimdLevel() != SimdLevel::Scalar;
+}
+
+//output[n] = input[n] * window[n] for interleaved complex items and real window, input may equal output
+template<typename Real>
+void WindowMultiplyScalar(const std::pair<Real, Real>* input, const Real* window, std::pair<Real, Real>* output, unsigned int size)
+{
+	for (unsigned int index = 0; index < size; ++index)
+	{
+		output[index] = { input[index].first * window[index], input[index].second * window[index] };
+	}
+}
+
+#if SIGNALS_X86
+
+//every window item is duplicated to cover real and imaginary part of its complex item
+inline unsigned int WindowMultiplySse2(const float* input, const float* window, float* output, unsigned int size)
+{
+	unsigned int index = 0;
+	for (; index + 4 <= size; index += 4)
+	{
+		__m128 weights = _mm_loadu_ps(window + index);
+		__m128 low = _mm_unpacklo_ps(weights, weights);
+		__m128 high = _mm_unpackhi_ps(weights, weights);
+
+		_mm_storeu_ps(output + 2 * index, _mm_mul_ps(_mm_loadu_ps(input + 2 * index), low));
+		_mm_storeu_ps(output + 2 * index + 4, _mm_mul_ps(_mm_loadu_ps(input + 2 * index + 4), high));
+	}
+	return index;
+}
+
+SIGNALS_TARGET_AVX2 inline unsigned int WindowMultiplyAvx2(const float* input, const float* window, float* output, unsigned int size)
+{
+	unsigned int index = 0;
+	for (; index + 8 <= size; index += 8)
+	{
+		//unpack works per 128 bit lane, permute puts w0..w3 pairs in first register and w4..w7 in second
+		__m256 weights = _mm256_loadu_ps(window + index);
+		__m256 unpackedLow = _mm256_unpacklo_ps(weights, weights);
+		__m256 unpackedHigh = _mm256_unpackhi_ps(weights, weights);
+		__m256 low = _mm256_permute2f128_ps(unpackedLow, unpackedHigh, 0x20);
+		__m256 high = _mm256_permute2f128_ps(unpackedLow, unpackedHigh, 0x31);
+
+		_mm256_storeu_ps(output + 2 * index, _mm256_mul_ps(_mm256_loadu_ps(input + 2 * index), low));
+		_mm256_storeu_ps(output + 2 * index + 8, _mm256_mul_ps(_mm256_loadu_ps(input + 2 * index + 8), high));
+	}
+	return index;
+}
+
+#endif
+
+//one pass over memory, avx-512 level uses avx2 kernel since loop is bound by loads and stores
+inline void WindowMultiply(const std::pair<float, float>* input, const float* window, std::pair<float, float>* output, unsigned int size)
+{
+	unsigned int done = 0;
+
+#if SIGNALS_X86
+	const float* inputItems = reinterpret_cast<const float*>(input);
+	float* outputItems = reinterpret_cast<float*>(output);
+
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::Sse2:
+		done = WindowMultiplySse2(inputItems, window, outputItems, size);
+		break;
+	case SimdLevel::Avx2:
+	case SimdLevel::Avx512:
+		done = WindowMultiplyAvx2(inputItems, window, outputItems, size);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	WindowMultiplyScalar(input + done, window + done, output + done, size - done);
+}
+
+inline void WindowMultiply(const std::pair<double, double>* input, const double* window, std::pair<double, double>* output, unsigned int size)
+{
+	WindowMultiplyScalar(input, window, output, size);
+}
+
+//FIR over block, output[n] = sum taps[j] * input[n + j] for j < numTaps, taps are stored reversed
+//so every output reads contiguous input, input holds count + numTaps - 1 items
+template<typename Real>
+unsigned int FirBlockScalar(const Real* input, const Real* taps, unsigned int numTaps, Real* output, unsigned int count)
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		Real sum = Real(0);
+		for (unsigned int tap = 0; tap < numTaps; ++tap)
+		{
+			sum += taps[tap] * input[index + tap];
+		}
+		output[index] = sum;
+	}
+	return count;
+}
+
+template<typename Real>
+Real DotScalar(const Real* a, const Real* b, unsigned int count)
+{
+	Real sum = Real(0);
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		sum += a[index] * b[index];
+	}
+	return sum;
+}
+
+#if SIGNALS_X86
+
+//vectorized across outputs: every tap is broadcast once and multiplied with 4 vectors of consecutive inputs,
+//4 independent sums hide add latency and there is no horizontal reduction
+#define SIGNALS_FIR_BLOCK(VEC, LOAD, STORE, ADD, MUL, SET1, ZERO, WIDTH)						\
+	unsigned int index = 0;																		\
+	for (; index + 4 * WIDTH <= count; index += 4 * WIDTH)										\
+	{																							\
+		VEC sum0 = ZERO();																		\
+		VEC sum1 = ZERO();																		\
+		VEC sum2 = ZERO();																		\
+		VEC sum3 = ZERO();																		\
+		const float* samples = input + index;													\
+		for (unsigned int tap = 0; tap < numTaps; ++tap)										\
+		{																						\
+			VEC weight = SET1(taps[tap]);														\
+			sum0 = ADD(sum0, MUL(weight, LOAD(samples + tap)));									\
+			sum1 = ADD(sum1, MUL(weight, LOAD(samples + tap + WIDTH)));							\
+			sum2 = ADD(sum2, MUL(weight, LOAD(samples + tap + 2 * WIDTH)));						\
+			sum3 = ADD(sum3, MUL(weight, LOAD(samples + tap + 3 * WIDTH)));						\
+		}																						\
+		STORE(output + index, sum0);															\
+		STORE(output + index + WIDTH, sum1);													\
+		STORE(output + index + 2 * WIDTH, sum2);												\
+		STORE(output + index + 3 * WIDTH, sum3);												\
+	}																							\
+	for (; index + WIDTH <= count; index += WIDTH)												\
+	{																							\
+		VEC sum = ZERO();																		\
+		for (unsigned int tap = 0; tap < numTaps; ++tap)										\
+		{																						\
+			sum = ADD(sum, MUL(SET1(taps[tap]), LOAD(input + index + tap)));					\
+		}																						\
+		STORE(output + index, sum);																\
+	}																							\
+	return index;
+
+//4 partial sums over strided items, reduced once at end
+#define SIGNALS_DOT(VEC, LOAD, STORE, ADD, MUL, ZERO, WIDTH)									\
+	VEC sum0 = ZERO();																			\
+	VEC sum1 = ZERO();																			\
+	VEC sum2 = ZERO();																			\
+	VEC sum3 = ZERO();																			\
+	unsigned int index = 0;																		\
+	for (; index + 4 * WIDTH <= count; index += 4 * WIDTH)										\
+	{																							\
+		sum0 = ADD(sum0, MUL(LOAD(a + index), LOAD(b + index)));								\
+		sum1 = ADD(sum1, MUL(LOAD(a + index + WIDTH), LOAD(b + index + WIDTH)));				\
+		sum2 = ADD(sum2, MUL(LOAD(a + index + 2 * WIDTH), LOAD(b + index + 2 * WIDTH)));		\
+		sum3 = ADD(sum3, MUL(LOAD(a + index + 3 * WIDTH), LOAD(b + index + 3 * WIDTH)));		\
+	}																							\
+	for (; index + WIDTH <= count; index += WIDTH)												\
+	{																							\
+		sum0 = ADD(sum0, MUL(LOAD(a + index), LOAD(b + index)));								\
+	}																							\
+	float lanes[WIDTH];																			\
+	STORE(lanes, ADD(ADD(sum0, sum1), ADD(sum2, sum3)));										\
+	float sum = 0.f;																			\
+	for (unsigned int lane = 0; lane < WIDTH; ++lane)											\
+	{																							\
+		sum += lanes[lane];																		\
+	}																							\
+	return sum + DotScalar(a + index, b + index, count - index);
+
+inline unsigned int FirBlockSse2(const float* input, const float* taps, unsigned int numTaps, float* output, unsigned int count)
+{
+	SIGNALS_FIR_BLOCK(__m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_mul_ps, _mm_set1_ps, _mm_setzero_ps, 4)
+}
+
+SIGNALS_TARGET_AVX2 inline unsigned int FirBlockAvx2(const float* input, const float* taps, unsigned int numTaps, float* output, unsigned int count)
+{
+	SIGNALS_FIR_BLOCK(__m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_mul_ps, _mm256_set1_ps, _mm256_setzero_ps, 8)
+}
+
+SIGNALS_TARGET_AVX512 inline unsigned int FirBlockAvx512(const float* input, const float* taps, unsigned int numTaps, float* output, unsigned int count)
+{
+	SIGNALS_FIR_BLOCK(__m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, _mm512_mul_ps, _mm512_set1_ps, _mm512_setzero_ps, 16)
+}
+
+inline float DotSse2(const float* a, const float* b, unsigned int count)
+{
+	SIGNALS_DOT(__m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_mul_ps, _mm_setzero_ps, 4)
+}
+
+SIGNALS_TARGET_AVX2 inline float DotAvx2(const float* a, const float* b, unsigned int count)
+{
+	SIGNALS_DOT(__m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_mul_ps, _mm256_setzero_ps, 8)
+}
+
+SIGNALS_TARGET_AVX512 inline float DotAvx512(const float* a, const float* b, unsigned int count)
+{
+	SIGNALS_DOT(__m512, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_add_ps, _mm512_mul_ps, _mm512_setzero_ps, 16)
+}
+
+#undef SIGNALS_FIR_BLOCK
+#undef SIGNALS_DOT
+
+#endif
+
+inline void FirBlock(const float* input, const float* taps, unsigned int numTaps, float* output, unsigned int count)
+{
+	unsigned int done = 0;
+
+#if SIGNALS_X86
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::Sse2:
+		done = FirBlockSse2(input, taps, numTaps, output, count);
+		break;
+	case SimdLevel::Avx2:
+		done = FirBlockAvx2(input, taps, numTaps, output, count);
+		break;
+	case SimdLevel::Avx512:
+		done = FirBlockAvx512(input, taps, numTaps, output, count);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	FirBlockScalar(input + done, taps, numTaps, output + done, count - done);
+}
+
+inline void FirBlock(const double* input, const double* taps, unsigned int numTaps, double* output, unsigned int count)
+{
+	FirBlockScalar(input, taps, numTaps, output, count);
+}
+
+inline float Dot(const float* a, const float* b, unsigned int count)
+{
+#if SIGNALS_X86
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::Sse2:
+		return DotSse2(a, b, count);
+	case SimdLevel::Avx2:
+		return DotAvx2(a, b, count);
+	case SimdLevel::Avx512:
+		return DotAvx512(a, b, count);
+	default:
+		break;
+	}
+#endif
+
+	return DotScalar(a, b, count);
+}
+
+inline double Dot(const double* a, const double* b, unsigned int count)
+{
+	return DotScalar(a, b, count);
+}
+
+//biquad cascade over lanes of independent channels, data is [n * width + lane] and filtered in place
+//coefficients are b0, b1, b2, a1, a2 per section, state is s1 lanes then s2 lanes per section (transposed direct form II)
+//recursion runs along samples so channels are what gets vectorized, same coefficients for every lane
+template<typename Real>
+void BiquadLanesScalar(Real* data, unsigned int count, const Real* coefficients, unsigned int numSections, Real* state, unsigned int width)
+{
+	for (unsigned int section = 0; section < numSections; ++section)
+	{
+		const Real* c = coefficients + 5 * section;
+		Real* s = state + 2 * width * section;
+		for (unsigned int lane = 0; lane < width; ++lane)
+		{
+			Real s1 = s[lane];
+			Real s2 = s[width + lane];
+			for (unsigned int index = 0; index < count; ++index)
+			{
+				Real& item = data[index * width + lane];
+				Real x = item;
+				Real y = c[0] * x + s1;
+				s1 = c[1] * x - c[3] * y + s2;
+				s2 = c[2] * x - c[4] * y;
+				item = y;
+			}
+			s[lane] = s1;
+			s[width + lane] = s2;
+		}
+	}
+}
+
+#if SIGNALS_X86
+
+#define SIGNALS_BIQUAD_LANES(VEC, LOAD, STORE, ADD, SUB, MUL, SET1, WIDTH)						\
+	for (unsigned int section = 0; section < numSections; ++section)							\
+	{																							\
+		const float* c = coefficients + 5 * section;											\
+		VEC b0 = SET1(c[0]), b1 = SET1(c[1]), b2 = SET1(c[2]), a1 = SET1(c[3]), a2 = SET1(c[4]);	\
+		float* s = state + 2 * WIDTH * section;													\
+		VEC s1 = LOAD(s), s2 = LOAD(s + WIDTH);													\
+		for (unsigned int index = 0; index < count; ++index)									\
+		{																						\
+			float* item = data + index * WIDTH;													\
+			VEC x = LOAD(item);																	\
+			VEC y = ADD(MUL(b0, x), s1);														\
+			s1 = ADD(SUB(MUL(b1, x), MUL(a1, y)), s2);											\
+			s2 = SUB(MUL(b2, x), MUL(a2, y));													\
+			STORE(item, y);																		\
+		}																						\
+		STORE(s, s1);																			\
+		STORE(s + WIDTH, s2);																	\
+	}
+
+inline void BiquadLanesSse2(float* data, unsigned int count, const float* coefficients, unsigned int numSections, float* state)
+{
+	SIGNALS_BIQUAD_LANES(__m128, _mm_load_ps, _mm_store_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_set1_ps, 4)
+}
+
+SIGNALS_TARGET_AVX2 inline void BiquadLanesAvx2(float* data, unsigned int count, const float* coefficients, unsigned int numSections, float* state)
+{
+	SIGNALS_BIQUAD_LANES(__m256, _mm256_load_ps, _mm256_store_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_set1_ps, 8)
+}
+
+SIGNALS_TARGET_AVX512 inline void BiquadLanesAvx512(float* data, unsigned int count, const float* coefficients, unsigned int numSections, float* state)
+{
+	SIGNALS_BIQUAD_LANES(__m512, _mm512_load_ps, _mm512_store_ps, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_set1_ps, 16)
+}
+
+#undef SIGNALS_BIQUAD_LANES
+
+#endif
+
+//kernel for lane width of GetSimdWidth(level), data and state have to be aligned to vector size
+typedef void(*BiquadLanesKernel)(float*, unsigned int, const float*, unsigned int, float*);
+
+inline BiquadLanesKernel GetBiquadLanesKernel(SimdLevel level)
+{
+#if SIGNALS_X86
+	switch (level)
+	{
+	case SimdLevel::Sse2:
+		return BiquadLanesSse2;
+	case SimdLevel::Avx2:
+		return BiquadLanesAvx2;
+	case SimdLevel::Avx512:
+		return BiquadLanesAvx512;
+	default:
+		break;
+	}
+#endif
+	return nullptr;
+}
+
+
+//acc[n] += a[n] * b[n] for interleaved complex items
+template<typename Real>
+void ComplexMultiplyAddScalar(const std::pair<Real, Real>* a, const std::pair<Real, Real>* b, std::pair<Real, Real>* acc, unsigned int count)
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		acc[index].first += a[index].first * b[index].first - a[index].second * b[index].second;
+		acc[index].second += a[index].first * b[index].second + a[index].second * b[index].first;
+	}
+}
+
+#if SIGNALS_X86
+
+//re and im of a are duplicated across item, b is swapped to (im, re), sign of first product of pair is flipped
+inline unsigned int ComplexMultiplyAddSse2(const float* a, const float* b, float* acc, unsigned int count)
+{
+	const __m128 sign = _mm_setr_ps(-0.f, 0.f, -0.f, 0.f);
+
+	unsigned int index = 0;
+	for (; index + 2 <= count; index += 2)
+	{
+		__m128 valueA = _mm_loadu_ps(a + 2 * index);
+		__m128 valueB = _mm_loadu_ps(b + 2 * index);
+
+		__m128 real = _mm_shuffle_ps(valueA, valueA, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 imag = _mm_shuffle_ps(valueA, valueA, _MM_SHUFFLE(3, 3, 1, 1));
+		__m128 swapped = _mm_shuffle_ps(valueB, valueB, _MM_SHUFFLE(2, 3, 0, 1));
+
+		__m128 product = _mm_add_ps(_mm_mul_ps(real, valueB), _mm_xor_ps(_mm_mul_ps(imag, swapped), sign));
+		_mm_storeu_ps(acc + 2 * index, _mm_add_ps(_mm_loadu_ps(acc + 2 * index), product));
+	}
+	return index;
+}
+
+SIGNALS_TARGET_AVX2 inline unsigned int ComplexMultiplyAddAvx2(const float* a, const float* b, float* acc, unsigned int count)
+{
+	unsigned int index = 0;
+	for (; index + 4 <= count; index += 4)
+	{
+		__m256 valueA = _mm256_loadu_ps(a + 2 * index);
+		__m256 valueB = _mm256_loadu_ps(b + 2 * index);
+
+		__m256 real = _mm256_moveldup_ps(valueA);
+		__m256 imag = _mm256_movehdup_ps(valueA);
+		__m256 swapped = _mm256_permute_ps(valueB, _MM_SHUFFLE(2, 3, 0, 1));
+
+		//addsub subtracts in even items and adds in odd ones
+		__m256 product = _mm256_addsub_ps(_mm256_mul_ps(real, valueB), _mm256_mul_ps(imag, swapped));
+		_mm256_storeu_ps(acc + 2 * index, _mm256_add_ps(_mm256_loadu_ps(acc + 2 * index), product));
+	}
+	return index;
+}
+
+#endif
+
+//avx-512 level uses avx2 kernel, loop is bound by loads and stores
+inline void ComplexMultiplyAdd(const std::pair<float, float>* a, const std::pair<float, float>* b, std::pair<float, float>* acc, unsigned int count)
+{
+	unsigned int done = 0;
+
+#if SIGNALS_X86
+	const float* itemsA = reinterpret_cast<const float*>(a);
+	const float* itemsB = reinterpret_cast<const float*>(b);
+	float* itemsAcc = reinterpret_cast<float*>(acc);
+
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::Sse2:
+		done = ComplexMultiplyAddSse2(itemsA, itemsB, itemsAcc, count);
+		break;
+	case SimdLevel::Avx2:
+	case SimdLevel::Avx512:
+		done = ComplexMultiplyAddAvx2(itemsA, itemsB, itemsAcc, count);
+		break;
+	default:
+		break;
+	}
+#endif
+
+	ComplexMultiplyAddScalar(a + done, b + done, acc + done, count - done);
+}
+
+inline void ComplexMultiplyAdd(const std::pair<double, double>* a, const std::pair<double, double>* b, std::pair<double, double>* acc, unsigned int count)
+{
+	ComplexMultiplyAddScalar(a, b, acc, count);
+}
+
+//farrow interpolation, output i is at position + (first + i) * step of buffer, integer part n picks window
+//buffer[n .. n + numTaps - 1] and fraction mu gives tap weights w[j] = sum table[k * numTaps + j] * mu^k by horner,
+//weights of whole window are evaluated side by side so every output is degree multiply-adds plus one dot per vector
+template<typename Real>
+void FarrowBlockScalar(const Real* buffer, const Real* table, unsigned int numTaps, unsigned int degree,
+	double position, double step, unsigned int first, unsigned int count, Real* output)
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		double time = position + static_cast<double>(first + index) * step;
+		double start = floor(time);
+		Real mu = static_cast<Real>(time - start);
+		const Real* window = buffer + static_cast<long long>(start);
+
+		Real sum = Real(0);
+		for (unsigned int tap = 0; tap < numTaps; ++tap)
+		{
+			Real weight = table[static_cast<size_t>(degree) * numTaps + tap];
+			for (unsigned int power = degree; power-- > 0; )
+			{
+				weight = weight * mu + table[static_cast<size_t>(power) * numTaps + tap];
+			}
+			sum += weight * window[tap];
+		}
+		output[index] = sum;
+	}
+}
+
+#if SIGNALS_X86
+
+//numTaps has to be multiple of 4
+inline void FarrowBlockSse2(const float* buffer, const float* table, unsigned int numTaps, unsigned int degree,
+	double position, double step, unsigned int first, unsigned int count, float* output)
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		double time = position + static_cast<double>(first + index) * step;
+		double start = floor(time);
+		__m128 mu = _mm_set1_ps(static_cast<float>(time - start));
+		const float* window = buffer + static_cast<long long>(start);
+
+		__m128 sum = _mm_setzero_ps();
+		for (unsigned int tap = 0; tap < numTaps; tap += 4)
+		{
+			__m128 weight = _mm_loadu_ps(table + static_cast<size_t>(degree) * numTaps + tap);
+			for (unsigned int power = degree; power-- > 0; )
+			{
+				weight = _mm_add_ps(_mm_mul_ps(weight, mu), _mm_loadu_ps(table + static_cast<size_t>(power) * numTaps + tap));
+			}
+			sum = _mm_add_ps(sum, _mm_mul_ps(weight, _mm_loadu_ps(window + tap)));
+		}
+
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+		output[index] = _mm_cvtss_f32(sum);
+	}
+}
+
+//numTaps has to be multiple of 8
+SIGNALS_TARGET_AVX2 inline void FarrowBlockAvx2(const float* buffer, const float* table, unsigned int numTaps, unsigned int degree,
+	double position, double step, unsigned int first, unsigned int count, float* output)
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		double time = position + static_cast<double>(first + index) * step;
+		double start = floor(time);
+		__m256 mu = _mm256_set1_ps(static_cast<float>(time - start));
+		const float* window = buffer + static_cast<long long>(start);
+
+		__m256 sum = _mm256_setzero_ps();
+		for (unsigned int tap = 0; tap < numTaps; tap += 8)
+		{
+			__m256 weight = _mm256_loadu_ps(table + static_cast<size_t>(degree) * numTaps + tap);
+			for (unsigned int power = degree; power-- > 0; )
+			{
+				weight = _mm256_add_ps(_mm256_mul_ps(weight, mu), _mm256_loadu_ps(table + static_cast<size_t>(power) * numTaps + tap));
+			}
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(weight, _mm256_loadu_ps(window + tap)));
+		}
+
+		__m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+		half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+		half = _mm_add_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1)));
+		output[index] = _mm_cvtss_f32(half);
+	}
+}
+
+#endif
+
+//avx2 kernel needs numTaps multiple of 8 and runs for avx-512 level as well, windows are too short for 16 lanes
+inline void FarrowBlock(const float* buffer, const float* table, unsigned int numTaps, unsigned int degree,
+	double position, double step, unsigned int first, unsigned int count, float* output)
+{
+#if SIGNALS_X86
+	SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::Avx2 && numTaps % 8 == 0)
+	{
+		FarrowBlockAvx2(buffer, table, numTaps, degree, position, step, first, count, output);
+		return;
+	}
+	if (level >= SimdLevel::Sse2 && numTaps % 4 == 0)
+	{
+		FarrowBlockSse2(buffer, table, numTaps, degree, position, step, first, count, output);
+		return;
+	}
+#endif
+
+	FarrowBlockScalar(buffer, table, numTaps, degree, position, step, first, count, output);
+}
+
+inline void FarrowBlock(const double* buffer, const double* table, unsigned int numTaps, unsigned int degree,
+	double position, double step, unsigned int first, unsigned int count, double* output)
+{
+	FarrowBlockScalar(buffer, table, numTaps, degree, position, step, first, count, output);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "Signal.h"
+
+//DFT of last windowSize samples at few tracked bins, updated in O(K) per incoming sample
+//X_k(n) = exp(i2PIk/N) * (r * X_k(n-1) + x(n) - r^N * x(n-N))
+//damping r = 1 gives exact window DFT but rounding errors are never forgotten, r slightly below 1
+//(for example 0.9999) keeps recurrence stable for endless streams at cost of tiny bias
+//state and twiddles are kept in double, window starts zero filled
+class SlidingDFT
+{
+public:
+	SlidingDFT(unsigned int windowSize, const std::vector<unsigned int>& bins, double damping = 1.0) :
+		_windowSize(windowSize),
+		_bins(bins),
+		_damping(damping),
+		_dampingPowN(pow(damping, static_cast<double>(windowSize))),
+		_history(windowSize, { 0.0, 0.0 }),
+		_values(bins.size(), { 0.0, 0.0 })
+	{
+		const double twoPi = 6.283185307179586476925;
+
+		_twiddles.resize(bins.size());
+		for (size_t index = 0; index < bins.size(); ++index)
+		{
+			double angle = windowSize != 0 ? twoPi * bins[index] / windowSize : 0.0;
+			_twiddles[index] = { cos(angle), sin(angle) };
+		}
+	}
+
+	unsigned int GetWindowSize() const
+	{
+		return _windowSize;
+	}
+
+	const std::vector<unsigned int>& GetBins() const
+	{
+		return _bins;
+	}
+
+	//true once windowSize samples were pushed, before that window is partly zero
+	bool IsWindowFull() const
+	{
+		return _numSamples >= _windowSize;
+	}
+
+	void Push(const Complex& sample)
+	{
+		if (_windowSize == 0)
+		{
+			return;
+		}
+
+		std::pair<double, double>& oldest = _history[_position];
+		double deltaReal = sample.first - _dampingPowN * oldest.first;
+		double deltaImg = sample.second - _dampingPowN * oldest.second;
+
+		oldest = { sample.first, sample.second };
+		_position = _position + 1 == _windowSize ? 0 : _position + 1;
+		++_numSamples;
+
+		for (size_t index = 0; index < _values.size(); ++index)
+		{
+			std::pair<double, double>& value = _values[index];
+			const std::pair<double, double>& twiddle = _twiddles[index];
+
+			double real = _damping * value.first + deltaReal;
+			double img = _damping * value.second + deltaImg;
+
+			value = { real * twiddle.first - img * twiddle.second, real * twiddle.second + img * twiddle.first };
+		}
+	}
+
+	void Push(float sample)
+	{
+		Push(Complex{ sample, 0.f });
+	}
+
+	//feeds every sample of signal in order
+	void Push(const RawSignalPtr& signal)
+	{
+		for (const auto& sample : signal->_dataVec)
+		{
+			Push(sample);
+		}
+	}
+
+	//current value of tracked bin index (position in bins given to constructor), scaled by 1/N same as FastFT
+	Complex GetValue(size_t index) const
+	{
+		return { static_cast<float>(_values[index].first / _windowSize), static_cast<float>(_values[index].second / _windowSize) };
+	}
+
+	//all tracked bins scaled by 1/N, time slot holds bin number so result can go to GetAmplitudesFromSignals
+	//samplingRate is rate of pushed samples, result carries it
+	RawSignalPtr GetValues(unsigned int samplingRate = SamplingRate) const
+	{
+		RawSignalPtr result(new RawSignal(static_cast<unsigned int>(_values.size()), samplingRate));
+
+		for (size_t index = 0; index < _values.size(); ++index)
+		{
+			result->_timeVec[index] = static_cast<float>(_bins[index]);
+			result->_dataVec[index] = GetValue(index);
+		}
+
+		return result;
+	}
+
+	void Reset()
+	{
+		std::fill(_history.begin(), _history.end(), std::pair<double, double>{ 0.0, 0.0 });
+		std::fill(_values.begin(), _values.end(), std::pair<double, double>{ 0.0, 0.0 });
+		_position = 0;
+		_numSamples = 0;
+	}
+
+private:
+	unsigned int _windowSize{ 0 };
+	std::vector<unsigned int> _bins;
+	double _damping{ 1.0 };
+	double _dampingPowN{ 1.0 };
+	std::vector<std::pair<double, double>> _history;
+	std::vector<std::pair<double, double>> _values;
+	std::vector<std::pair<double, double>> _twiddles;
+	unsigned int _position{ 0 };
+	unsigned long long _numSamples{ 0 };
+};
\ No newline at end of file
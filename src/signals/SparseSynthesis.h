@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <math.h>
+#include "ThreadPool.h"
+
+//spectra with at most this fraction of nonzero bins are inverted by sparse synthesis instead of inverse FFT,
+//can be changed with SetSparseSynthesisDensity
+inline std::atomic<float>& SparseSynthesisDensity()
+{
+	static std::atomic<float> density{ 0.01f };
+	return density;
+}
+
+inline void SetSparseSynthesisDensity(float density)
+{
+	SparseSynthesisDensity() = density;
+}
+
+//one nonzero coefficient of N point spectrum
+template<typename Real>
+struct SparseCoefficientT
+{
+	unsigned int bin;
+	std::pair<Real, Real> value;
+};
+
+using SparseCoefficient = SparseCoefficientT<float>;
+
+//collects bins whose magnitude is above threshold, zero threshold keeps every exactly nonzero bin
+template<typename Real>
+std::vector<SparseCoefficientT<Real>> ExtractSparseCoefficients(const std::pair<Real, Real>* spectrum, unsigned int size, Real threshold = Real(0))
+{
+	std::vector<SparseCoefficientT<Real>> coefficients;
+	Real thresholdSquared = threshold * threshold;
+
+	for (unsigned int bin = 0; bin < size; ++bin)
+	{
+		const std::pair<Real, Real>& value = spectrum[bin];
+		Real magnitudeSquared = value.first * value.first + value.second * value.second;
+		if (magnitudeSquared > thresholdSquared)
+		{
+			coefficients.push_back({ bin, value });
+		}
+	}
+
+	return coefficients;
+}
+
+//true when spectrum of size bins with numCoefficients nonzero bins should take sparse path
+inline bool UseSparseSynthesis(size_t numCoefficients, unsigned int size)
+{
+	return numCoefficients <= SparseSynthesisDensity() * size;
+}
+
+//inverse DFT from few coefficients, output[n] = sum c_k * exp(i2PI * bin_k * n / N), no scaling like inverse FFT
+//every coefficient is oscillator c_k * exp(i2PI * bin_k * n / N) advanced by one complex multiply per sample,
+//all oscillators step together so inner loop vectorizes, oscillators are reset exactly every resyncInterval samples
+//sample ranges are spread across thread pool, O(N * K)
+template<typename Real>
+void SynthesizeSparse(const std::vector<SparseCoefficientT<Real>>& coefficients, unsigned int size, std::pair<Real, Real>* output)
+{
+	const unsigned int resyncInterval = 1024;
+	const double twoPi = 6.283185307179586476925;
+
+	size_t numCoefficients = coefficients.size();
+
+	std::vector<double> stepReal(numCoefficients);
+	std::vector<double> stepImg(numCoefficients);
+	for (size_t index = 0; index < numCoefficients; ++index)
+	{
+		double angle = size != 0 ? twoPi * (coefficients[index].bin % size) / size : 0.0;
+		stepReal[index] = cos(angle);
+		stepImg[index] = sin(angle);
+	}
+
+	GetThreadPool().ParallelFor(size, [&](unsigned int begin, unsigned int end)
+	{
+		std::vector<double> oscillatorReal(numCoefficients);
+		std::vector<double> oscillatorImg(numCoefficients);
+
+		for (unsigned int sample = begin; sample < end; ++sample)
+		{
+			if ((sample - begin) % resyncInterval == 0)
+			{
+				for (size_t index = 0; index < numCoefficients; ++index)
+				{
+					const SparseCoefficientT<Real>& coefficient = coefficients[index];
+					unsigned long long exponent = (static_cast<unsigned long long>(coefficient.bin) * sample) % size;
+					double angle = twoPi * exponent / size;
+					double real = cos(angle);
+					double img = sin(angle);
+
+					oscillatorReal[index] = coefficient.value.first * real - coefficient.value.second * img;
+					oscillatorImg[index] = coefficient.value.first * img + coefficient.value.second * real;
+				}
+			}
+
+			double sumReal = 0.0;
+			double sumImg = 0.0;
+			for (size_t index = 0; index < numCoefficients; ++index)
+			{
+				double real = oscillatorReal[index];
+				double img = oscillatorImg[index];
+
+				sumReal += real;
+				sumImg += img;
+
+				oscillatorReal[index] = real * stepReal[index] - img * stepImg[index];
+				oscillatorImg[index] = real * stepImg[index] + img * stepReal[index];
+			}
+
+			output[sample] = { static_cast<Real>(sumReal), static_cast<Real>(sumImg) };
+		}
+	}, 4096);
+}
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <math.h>
+#include "Signal.h"
+
+enum class SpectrumLayout
+{
+	TwoSided,	//N bins, bin N-k mirrors bin k (FastFT, DiscreteFT)
+	OneSided	//N/2+1 non redundant bins of real signal (RealFastFT)
+};
+
+//FT coefficients together with frequency axis of signal they came from
+//frequency of bin k is k * samplingRate / N so Hz to bin lookup is one multiply,
+//masks zero or scale only bins in affected ranges (and their mirrors) in place
+class Spectrum
+{
+public:
+	//coefficients of signalSize samples long signal, sampling rate is taken from coefficients
+	Spectrum(RawSignalPtr&& coefficients, unsigned int signalSize, SpectrumLayout layout) :
+		_coefficients(move(coefficients)),
+		_signalSize(signalSize),
+		_samplingRate(_coefficients->GetSamplingRate()),
+		_layout(layout)
+	{
+		_binsPerHertz = _samplingRate != 0 ? static_cast<double>(_signalSize) / _samplingRate : 0.0;
+	}
+
+	//two sided coefficients, one bin per sample
+	Spectrum(RawSignalPtr&& coefficients) :
+		Spectrum(move(coefficients), coefficients->Size(), SpectrumLayout::TwoSided)
+	{
+	}
+
+	unsigned int GetSignalSize() const
+	{
+		return _signalSize;
+	}
+
+	unsigned int GetSamplingRate() const
+	{
+		return _samplingRate;
+	}
+
+	SpectrumLayout GetLayout() const
+	{
+		return _layout;
+	}
+
+	unsigned int GetNumBins() const
+	{
+		return static_cast<unsigned int>(_coefficients->_dataVec.size());
+	}
+
+	//highest frequency bin, mirrors of bins up to this one are the rest of two sided spectrum
+	unsigned int GetNyquistBin() const
+	{
+		return _signalSize / 2;
+	}
+
+	float GetBinWidth() const
+	{
+		return _signalSize != 0 ? static_cast<float>(_samplingRate) / _signalSize : 0.f;
+	}
+
+	//fractional bin position of frequency
+	double GetBinPosition(float frequency) const
+	{
+		return frequency * _binsPerHertz;
+	}
+
+	//nearest bin of frequency, clamped to nyquist bin
+	unsigned int GetBin(float frequency) const
+	{
+		return ClampBin(floor(GetBinPosition(frequency) + 0.5));
+	}
+
+	float GetFrequency(unsigned int bin) const
+	{
+		return static_cast<float>(bin / _binsPerHertz);
+	}
+
+	//bin holding negative frequency of bin, one sided layout has no mirrors so bin itself is returned
+	unsigned int GetMirrorBin(unsigned int bin) const
+	{
+		if (_layout == SpectrumLayout::OneSided || bin == 0)
+		{
+			return bin;
+		}
+		return _signalSize - bin;
+	}
+
+	Complex& operator[](unsigned int bin)
+	{
+		return _coefficients->_dataVec[bin];
+	}
+
+	const Complex& operator[](unsigned int bin) const
+	{
+		return _coefficients->_dataVec[bin];
+	}
+
+	//coefficients for InverseFastFT, GetAmplitudesFromSignals and others
+	const RawSignalPtr& GetCoefficients() const
+	{
+		return _coefficients;
+	}
+
+	RawSignalPtr Release()
+	{
+		return move(_coefficients);
+	}
+
+	//multiplies bins from lowFrequency to highFrequency (rounded outwards to whole bins) and their mirrors by gain
+	void Scale(float lowFrequency, float highFrequency, float gain)
+	{
+		unsigned int first = ClampBin(floor(GetBinPosition(lowFrequency)));
+		unsigned int last = ClampBin(ceil(GetBinPosition(highFrequency)));
+		ScaleBins(first, last, gain);
+	}
+
+	//removes everything from lowFrequency to highFrequency
+	void BandStop(float lowFrequency, float highFrequency)
+	{
+		Scale(lowFrequency, highFrequency, 0.f);
+	}
+
+	//keeps only lowFrequency to highFrequency
+	void BandPass(float lowFrequency, float highFrequency)
+	{
+		unsigned int first = ClampBin(floor(GetBinPosition(lowFrequency)));
+		unsigned int last = ClampBin(ceil(GetBinPosition(highFrequency)));
+
+		if (first > 0)
+		{
+			ScaleBins(0, first - 1, 0.f);
+		}
+		if (last < GetNyquistBin())
+		{
+			ScaleBins(last + 1, GetNyquistBin(), 0.f);
+		}
+	}
+
+	//removes bins around every frequency, halfWidth in Hz, zero halfWidth removes two bins enclosing frequency
+	//or only its own bin when frequency falls exactly on one, mirrors go as well
+	void Notch(const std::vector<float>& frequencies, float halfWidth = 0.f)
+	{
+		for (float frequency : frequencies)
+		{
+			BandStop(frequency - halfWidth, frequency + halfWidth);
+		}
+	}
+
+private:
+	unsigned int ClampBin(double bin) const
+	{
+		if (bin < 0.0)
+		{
+			return 0;
+		}
+		unsigned int nyquistBin = GetNyquistBin();
+		return bin > nyquistBin ? nyquistBin : static_cast<unsigned int>(bin);
+	}
+
+	//scales bins first..last (inclusive, at most nyquist bin) and mirrored range in two sided layout
+	void ScaleBins(unsigned int first, unsigned int last, float gain)
+	{
+		if (first > last)
+		{
+			return;
+		}
+
+		Complex* bins = _coefficients->_dataVec.data();
+		unsigned int numBins = GetNumBins();
+		last = last < numBins ? last : numBins - 1;
+
+		auto ScaleRange = [&](unsigned int begin, unsigned int end)
+		{
+			if (gain == 0.f)
+			{
+				std::fill(bins + begin, bins + end, Complex{ 0.f, 0.f });
+				return;
+			}
+			for (unsigned int bin = begin; bin < end; ++bin)
+			{
+				bins[bin].first *= gain;
+				bins[bin].second *= gain;
+			}
+		};
+
+		ScaleRange(first, last + 1);
+
+		if (_layout == SpectrumLayout::TwoSided)
+		{
+			//mirrors of first..last are N-last..N-first, bin 0 has no mirror
+			unsigned int mirrorFirst = first == 0 ? 1 : first;
+			if (mirrorFirst <= last)
+			{
+				unsigned int begin = _signalSize - last;
+				unsigned int end = _signalSize - mirrorFirst + 1;
+
+				//even N nyquist bin is its own mirror and was scaled already
+				if (begin == last)
+				{
+					++begin;
+				}
+				if (begin < end)
+				{
+					ScaleRange(begin, end);
+				}
+			}
+		}
+	}
+
+	RawSignalPtr _coefficients;
+	unsigned int _signalSize{ 0 };
+	unsigned int _samplingRate{ 0 };
+	SpectrumLayout _layout{ SpectrumLayout::TwoSided };
+	double _binsPerHertz{ 0.0 };
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+//fixed set of worker threads running queued jobs
+//ParallelFor splits index range into chunks and blocks until all chunks are done
+class ThreadPool
+{
+public:
+	ThreadPool(unsigned int numThreads = std::thread::hardware_concurrency())
+	{
+		if (numThreads == 0)
+		{
+			numThreads = 1;
+		}
+
+		for (unsigned int index = 0; index < numThreads; ++index)
+		{
+			_workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_jobAvailable.notify_all();
+
+		for (auto& worker : _workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int GetNumThreads() const
+	{
+		return static_cast<unsigned int>(_workers.size());
+	}
+
+	//calls body(begin, end) for chunks covering [0, count), at most one chunk per thread unless minChunk limits it
+	//calls made from worker threads run inline so nested parallel loops cannot deadlock
+	void ParallelFor(unsigned int count, const std::function<void(unsigned int, unsigned int)>& body, unsigned int minChunk = 1)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		unsigned int numChunks = GetNumThreads();
+		if (minChunk > 0 && count / minChunk < numChunks)
+		{
+			numChunks = count / minChunk;
+		}
+
+		if (numChunks <= 1 || IsWorkerThread())
+		{
+			body(0, count);
+			return;
+		}
+
+		std::mutex doneMutex;
+		std::condition_variable allDone;
+		unsigned int remaining = numChunks;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (unsigned int chunk = 0; chunk < numChunks; ++chunk)
+			{
+				unsigned int begin = static_cast<unsigned int>(static_cast<unsigned long long>(count) * chunk / numChunks);
+				unsigned int end = static_cast<unsigned int>(static_cast<unsigned long long>(count) * (chunk + 1) / numChunks);
+
+				_jobs.push_back([&, begin, end]()
+				{
+					body(begin, end);
+
+					std::lock_guard<std::mutex> doneLock(doneMutex);
+					if (--remaining == 0)
+					{
+						allDone.notify_one();
+					}
+				});
+			}
+		}
+		_jobAvailable.notify_all();
+
+		std::unique_lock<std::mutex> doneLock(doneMutex);
+		allDone.wait(doneLock, [&]() { return remaining == 0; });
+	}
+
+private:
+	static bool& IsWorkerThread()
+	{
+		thread_local bool isWorker = false;
+		return isWorker;
+	}
+
+	void WorkerLoop()
+	{
+		IsWorkerThread() = true;
+
+		for (;;)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_jobAvailable.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+
+				if (_jobs.empty())
+				{
+					return;
+				}
+
+				job = std::move(_jobs.front());
+				_jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+
+	std::vector<std::thread> _workers;
+	std::deque<std::function<void()>> _jobs;
+	std::mutex _mutex;
+	std::condition_variable _jobAvailable;
+	bool _stopping{ false };
+};
+
+//pool shared by signal processing engines, created on first use
+inline ThreadPool& GetThreadPool()
+{
+	static ThreadPool pool;
+	return pool;
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "STFT.h"
+#include "ThreadPool.h"
+
+//welch power spectral density of real signal, average of periodograms of overlapping windowed segments
+//one sided: P[k] = c * mean(|X_k|^2) / (samplingRate * sum(w^2)), c = 2 for bins with negative frequency mirror
+//input is collected into batch of batchSize segments which are transformed in parallel by STFT,
+//periodograms are summed per bin in segment order so result does not depend on number of threads,
+//memory is fixed by batch size whatever the length of input
+template<typename Real>
+class WelchT
+{
+public:
+	using ComplexT = std::pair<Real, Real>;
+
+	//overlap is in samples and must be smaller than segmentSize, negative windowParameter picks default of window type
+	WelchT(unsigned int segmentSize, unsigned int overlap, unsigned int samplingRate, WindowType window = WindowType::Hann, unsigned int batchSize = 64, double windowParameter = -1.0) :
+		_segmentSize(segmentSize),
+		_hopSize(overlap < segmentSize ? segmentSize - overlap : segmentSize),
+		_samplingRate(samplingRate),
+		_batchSize(batchSize != 0 ? batchSize : 1),
+		_stft(segmentSize, _hopSize, window, 1, windowParameter)
+	{
+		WindowPtr<Real> table = GetWindow<Real>(window, _segmentSize, windowParameter);
+		double windowSum = GetWindowSum(table->data(), _segmentSize);
+		double windowPower = GetWindowPower(table->data(), _segmentSize);
+
+		//STFT frames are scaled by 1/sum(w), undo it and apply PSD scaling in one factor
+		_scale = windowPower != 0.0 && _samplingRate != 0 ? windowSum * windowSum / (_samplingRate * windowPower) : 0.0;
+
+		_buffer.resize(static_cast<size_t>(_batchSize - 1) * _hopSize + _segmentSize);
+		_frames.resize(static_cast<size_t>(_batchSize) * _segmentSize);
+		_sum.resize(GetNumBins());
+		Reset();
+	}
+
+	unsigned int GetSegmentSize() const
+	{
+		return _segmentSize;
+	}
+
+	unsigned int GetHopSize() const
+	{
+		return _hopSize;
+	}
+
+	//segmentSize/2 + 1 bins, bin k is frequency k * samplingRate / segmentSize
+	unsigned int GetNumBins() const
+	{
+		return _segmentSize / 2 + 1;
+	}
+
+	float GetBinFrequency(unsigned int bin) const
+	{
+		return _segmentSize != 0 ? static_cast<float>(bin) * _samplingRate / _segmentSize : 0.f;
+	}
+
+	//segments averaged so far, segments still waiting in batch are counted after GetPsd
+	unsigned long long GetNumSegments() const
+	{
+		return _numSegments;
+	}
+
+	void Push(const Real* input, unsigned int count)
+	{
+		Stream(input, count);
+	}
+
+	//only real part is used
+	void Push(const ComplexT* input, unsigned int count)
+	{
+		Stream(input, count);
+	}
+
+	//averages remaining whole segments in and writes GetNumBins() values, zeros when no segment was complete
+	void GetPsd(Real* output)
+	{
+		RunBatch();
+
+		unsigned int numBins = GetNumBins();
+		double scale = _numSegments != 0 ? _scale / _numSegments : 0.0;
+
+		for (unsigned int bin = 0; bin < numBins; ++bin)
+		{
+			//dc and even size nyquist bin have no mirror
+			bool mirrored = bin != 0 && 2 * bin != _segmentSize;
+			output[bin] = static_cast<Real>(_sum[bin] * scale * (mirrored ? 2.0 : 1.0));
+		}
+	}
+
+	void Reset()
+	{
+		std::fill(_sum.begin(), _sum.end(), 0.0);
+		_numBuffered = 0;
+		_numSegments = 0;
+	}
+
+private:
+	static Real ToReal(Real sample)
+	{
+		return sample;
+	}
+
+	static Real ToReal(const ComplexT& sample)
+	{
+		return sample.first;
+	}
+
+	template<typename Sample>
+	void Stream(const Sample* input, unsigned int count)
+	{
+		unsigned int capacity = static_cast<unsigned int>(_buffer.size());
+
+		for (unsigned int index = 0; index < count; )
+		{
+			unsigned int numCopied = (std::min)(count - index, capacity - _numBuffered);
+			for (unsigned int item = 0; item < numCopied; ++item)
+			{
+				_buffer[_numBuffered + item] = ToReal(input[index + item]);
+			}
+			_numBuffered += numCopied;
+			index += numCopied;
+
+			if (_numBuffered == capacity)
+			{
+				RunBatch();
+			}
+		}
+	}
+
+	//transforms whole segments in buffer and keeps samples of segments that are not complete yet
+	void RunBatch()
+	{
+		unsigned int numFrames = _stft.GetFrameCount(_numBuffered);
+		if (numFrames == 0)
+		{
+			return;
+		}
+
+		_stft.Execute(_buffer.data(), _numBuffered, _frames.data());
+
+		//every bin sums its frames in order, deterministic for any split of bins across threads
+		GetThreadPool().ParallelFor(GetNumBins(), [&](unsigned int binBegin, unsigned int binEnd)
+		{
+			for (unsigned int bin = binBegin; bin < binEnd; ++bin)
+			{
+				double sum = 0.0;
+				for (unsigned int frame = 0; frame < numFrames; ++frame)
+				{
+					const ComplexT& value = _frames[static_cast<size_t>(frame) * _segmentSize + bin];
+					sum += static_cast<double>(value.first) * value.first + static_cast<double>(value.second) * value.second;
+				}
+				_sum[bin] += sum;
+			}
+		}, 256);
+
+		_numSegments += numFrames;
+
+		unsigned int consumed = numFrames * _hopSize;
+		std::copy(_buffer.begin() + consumed, _buffer.begin() + _numBuffered, _buffer.begin());
+		_numBuffered -= consumed;
+	}
+
+	unsigned int _segmentSize{ 0 };
+	unsigned int _hopSize{ 0 };
+	unsigned int _samplingRate{ 0 };
+	unsigned int _batchSize{ 0 };
+	StftT<Real> _stft;
+	double _scale{ 0.0 };
+
+	std::vector<Real> _buffer;
+	unsigned int _numBuffered{ 0 };
+	std::vector<ComplexT> _frames;
+	std::vector<double> _sum;
+	unsigned long long _numSegments{ 0 };
+};
+
+using Welch = WelchT<float>;
\ No newline at end of file
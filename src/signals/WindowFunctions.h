@@ -0,0 +1,161 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <math.h>
+#include "SimdKernels.h"
+
+enum class WindowType
+{
+	Rectangular,
+	Hann,			//-31 dB sidelobes, good default for spectra
+	Hamming,		//-43 dB first sidelobe, slow decay
+	BlackmanHarris,	//4 term, -92 dB sidelobes, wide main lobe
+	Kaiser,			//parameter is beta, larger beta trades main lobe width for lower sidelobes
+	FlatTop,		//amplitude error below 0.01 dB between bins, for reading tone levels
+	Tukey			//parameter is tapered fraction, 0 is rectangular and 1 is hann
+};
+
+//default parameter of window types that have one
+inline double GetDefaultWindowParameter(WindowType type)
+{
+	switch (type)
+	{
+	case WindowType::Kaiser:
+		return 8.6;
+	case WindowType::Tukey:
+		return 0.5;
+	default:
+		return 0.0;
+	}
+}
+
+//zeroth order modified bessel function of first kind, series converges fast for kaiser beta range
+inline double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double quarterSquare = x * x / 4.0;
+	for (unsigned int k = 1; k < 64 && term > sum * 1e-17; ++k)
+	{
+		term *= quarterSquare / (static_cast<double>(k) * k);
+		sum += term;
+	}
+	return sum;
+}
+
+//value at index of window of size items
+//periodic windows repeat with period size and suit spectral analysis and overlap adding,
+//symmetric windows are symmetric around (size - 1) / 2 and suit filter design
+inline double GetWindowValue(WindowType type, unsigned int index, unsigned int size, double parameter, bool symmetric = false)
+{
+	const double twoPi = 6.283185307179586476925;
+
+	double length = symmetric ? static_cast<double>(size) - 1.0 : static_cast<double>(size);
+	if (length <= 0.0)
+	{
+		return 1.0;
+	}
+	double x = index / length;
+
+	switch (type)
+	{
+	case WindowType::Hann:
+		return 0.5 - 0.5 * cos(twoPi * x);
+	case WindowType::Hamming:
+		return 0.54 - 0.46 * cos(twoPi * x);
+	case WindowType::BlackmanHarris:
+		return 0.35875 - 0.48829 * cos(twoPi * x) + 0.14128 * cos(2.0 * twoPi * x) - 0.01168 * cos(3.0 * twoPi * x);
+	case WindowType::FlatTop:
+		return 0.21557895 - 0.41663158 * cos(twoPi * x) + 0.277263158 * cos(2.0 * twoPi * x)
+			- 0.083578947 * cos(3.0 * twoPi * x) + 0.006947368 * cos(4.0 * twoPi * x);
+	case WindowType::Kaiser:
+	{
+		double r = 2.0 * x - 1.0;
+		double root = 1.0 - r * r;
+		return BesselI0(parameter * sqrt(root > 0.0 ? root : 0.0)) / BesselI0(parameter);
+	}
+	case WindowType::Tukey:
+	{
+		//cosine tapers over parameter / 2 of window at each end, flat in between
+		if (parameter <= 0.0)
+		{
+			return 1.0;
+		}
+		double taper = parameter / 2.0;
+		double edge = x < 0.5 ? x : 1.0 - x;
+		return edge >= taper ? 1.0 : 0.5 - 0.5 * cos(twoPi * edge / parameter);
+	}
+	default:
+		return 1.0;
+	}
+}
+
+template<typename Real>
+using WindowPtr = std::shared_ptr<const AlignedVector<Real>>;
+
+//returns shared read only window table, tables are built on first use for every type, size, parameter
+//and symmetry and cached for lifetime of the program, negative parameter picks default of window type
+template<typename Real>
+WindowPtr<Real> GetWindow(WindowType type, unsigned int size, double parameter = -1.0, bool symmetric = false)
+{
+	using WindowKey = std::tuple<WindowType, unsigned int, double, bool>;
+	static std::mutex cacheMutex;
+	static std::map<WindowKey, WindowPtr<Real>> cache;
+
+	if (parameter < 0.0)
+	{
+		parameter = GetDefaultWindowParameter(type);
+	}
+	WindowKey key{ type, size, parameter, symmetric };
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+
+	auto found = cache.find(key);
+	if (found != cache.end())
+	{
+		return found->second;
+	}
+
+	std::shared_ptr<AlignedVector<Real>> window = std::make_shared<AlignedVector<Real>>(size);
+	for (unsigned int index = 0; index < size; ++index)
+	{
+		(*window)[index] = static_cast<Real>(GetWindowValue(type, index, size, parameter, symmetric));
+	}
+
+	cache.insert({ key, window });
+	return window;
+}
+
+//in place input[n] * window[n] over size complex items, vectorized
+template<typename Real>
+void ApplyWindow(std::pair<Real, Real>* data, const Real* window, unsigned int size)
+{
+	WindowMultiply(data, window, data, size);
+}
+
+//sum of window items, amplitude of windowed tone is scaled by it instead of by size
+template<typename Real>
+double GetWindowSum(const Real* window, unsigned int size)
+{
+	double sum = 0.0;
+	for (unsigned int index = 0; index < size; ++index)
+	{
+		sum += window[index];
+	}
+	return sum;
+}
+
+//sum of squared window items, power of windowed noise is scaled by it
+template<typename Real>
+double GetWindowPower(const Real* window, unsigned int size)
+{
+	double sum = 0.0;
+	for (unsigned int index = 0; index < size; ++index)
+	{
+		sum += static_cast<double>(window[index]) * window[index];
+	}
+	return sum;
+}
\ No newline at end of file